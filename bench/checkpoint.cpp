@@ -0,0 +1,93 @@
+// Benchmark of the checkpointing of the sweeps.
+//
+// Prices the same contract with and without a checkpoint for several intervals and reports
+// the number of saves, the time spent in them and the overhead on the whole pricing.
+//
+// Build from the root of the repository:
+//     g++ -O2 -std=c++17 -pthread -Isrc bench/checkpoint.cpp $(ls src/*.cpp | grep -v 'main\|sdl') -o bench_checkpoint
+// Usage:
+//     bench_checkpoint [M] [N] [file]
+// the checkpoint file being written in /tmp by default.
+
+#include "completecall.h"
+#include "reducedput.h"
+#include "checkpoint.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace ensiie;
+
+namespace
+{
+    // Best of a few runs, the first one warming the workspace and the page cache
+    const int runs = 3;
+
+    template <typename Engine>
+    double best_time(Engine& engine)
+    {
+        double best = 0;
+        for (int k = 0; k < runs; k++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            engine.pricing();
+            double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = (k == 0) ? time : std::min(best, time);
+        }
+        return best;
+    }
+
+    template <typename Engine>
+    void measure(const Data& d, const std::string& name, const std::string& path)
+    {
+        Engine plain(d);
+        double reference = best_time(plain);
+        std::cout << name << ": " << reference << " s without checkpoint\n";
+
+        for (int interval : { 1000, 100, 10 })
+        {
+            if (interval > d.get_M())
+            {
+                continue;
+            }
+
+            Engine engine(d);
+            Checkpoint checkpoint(path, interval);
+            engine.set_checkpoint(&checkpoint);
+            double time = best_time(engine);
+
+            // The counters of the checkpoint add up over the runs
+            int saves = checkpoint.get_saves() / runs;
+            double overhead = checkpoint.get_overhead() / runs;
+
+            std::cout << "  interval " << std::setw(5) << interval
+                << ": " << std::setw(4) << saves << " saves, "
+                << overhead * 1e3 << " ms saving (" << (saves > 0 ? overhead / saves * 1e6 : 0) << " us each), pricing "
+                << time << " s, overhead " << 100 * (time - reference) / reference << " %\n";
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try {
+        double M = (argc > 1) ? std::atof(argv[1]) : 2000;
+        double N = (argc > 2) ? std::atof(argv[2]) : 100000;
+        std::string path = (argc > 3) ? argv[3] : "/tmp/bench_checkpoint.bin";
+
+        Data d(1.0, 0.05, 0.2, 100, 400, M, N);
+        std::cout << std::setprecision(4) << "M = " << M << ", N = " << N << ", layer of " << (N + 1) * 8 / 1e6 << " MB\n";
+
+        measure<CompleteCall>(d, "CompleteCall", path);
+        measure<ReducedPut>(d, "ReducedPut", path);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
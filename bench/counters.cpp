@@ -0,0 +1,70 @@
+// Hardware counters of the engines.
+//
+// Measures the cycles, instructions, last-level cache misses and branch mispredictions of the
+// setup of each engine, per asset price node, and of its pricing, per node and time step.
+//
+// Build from the root of the repository:
+//     g++ -O2 -std=c++17 -pthread -Isrc bench/counters.cpp $(ls src/*.cpp | grep -v 'main\|sdl') -o bench_counters
+// Usage:
+//     bench_counters [M] [N]
+// The counters need perf_event_paranoid at 2 or below; otherwise the values are printed as n/a.
+
+#include "completecall.h"
+#include "completeput.h"
+#include "reducedcall.h"
+#include "reducedput.h"
+#include "perfcounters.h"
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace ensiie;
+
+namespace
+{
+    template <typename Engine>
+    void measure(const Data& d, PerfCounters& counters, const std::string& name)
+    {
+        double M = d.get_M();
+        double N = d.get_N();
+
+        counters.start();
+        Engine engine(d);
+        counters.stop();
+        std::cout << counters.report(name + " setup", N + 1) << '\n';
+
+        counters.start();
+        engine.pricing();
+        counters.stop();
+        std::cout << counters.report(name + " pricing", (N + 1) * M) << '\n';
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try {
+        double M = (argc > 1) ? std::atof(argv[1]) : 1000;
+        double N = (argc > 2) ? std::atof(argv[2]) : 100000;
+        Data d(1.0, 0.1, 0.1, 100, 300, M, N);
+
+        PerfCounters counters;
+        if (!counters.available())
+        {
+            std::cout << "Hardware counters unavailable (" << counters.get_error() << ")" << std::endl;
+        }
+        std::printf("%-24s %16s %8s %14s %14s %14s\n", "phase", "cycles", "IPC", "cycles/node", "misses/node", "branch/node");
+        std::fflush(stdout);
+
+        measure<CompleteCall>(d, counters, "CompleteCall");
+        measure<CompletePut>(d, counters, "CompletePut");
+        measure<ReducedCall>(d, counters, "ReducedCall");
+        measure<ReducedPut>(d, counters, "ReducedPut");
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include "batch.h"
+#include "trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace ensiie
+{
+	Batch::Batch(std::istream& in, std::ostream& out, bool binary, int chunk_size) : in_(in), out_(out), binary_(binary), chunk_size_(chunk_size), threads_(0), contracts_(0)
+	{
+		if (chunk_size <= 0)
+		{
+			throw std::invalid_argument("The chunk size must be positive");
+		}
+	}
+
+	void Batch::set_threads(unsigned int threads)
+	{
+		threads_ = threads;
+		cache_.set_threads(threads);
+	}
+
+	bool Batch::parse(const std::string& line, Contract& c, std::string& error)
+	{
+		std::string type;
+		double* fields[8] = { &c.T, &c.r, &c.sigma, &c.K, &c.L, &c.M, &c.N, &c.S };
+		const char* names[8] = { "T", "r", "sigma", "K", "L", "M", "N", "S" };
+		bool found[8] = { false, false, false, false, false, false, false, false };
+		const char* p = line.c_str();
+
+		while (*p == ' ' || *p == '\t')
+		{
+			p++;
+		}
+
+		if (*p == '{')
+		{
+			// Flat JSON object, "key": value pairs with a string or a number as value
+			p++;
+			while (true)
+			{
+				const char* quote = std::strchr(p, '"');
+				if (quote == nullptr)
+				{
+					break;
+				}
+				const char* end = std::strchr(quote + 1, '"');
+				if (end == nullptr)
+				{
+					break;
+				}
+				std::string key(quote + 1, end);
+
+				p = end + 1;
+				while (*p == ' ' || *p == '\t' || *p == ':')
+				{
+					p++;
+				}
+
+				if (*p == '"')
+				{
+					const char* close = std::strchr(p + 1, '"');
+					if (close == nullptr)
+					{
+						break;
+					}
+					if (key == "type")
+					{
+						type.assign(p + 1, close);
+					}
+					p = close + 1;
+				}
+				else
+				{
+					char* next;
+					double value = std::strtod(p, &next);
+					for (int k = 0; k < 8; k++)
+					{
+						if (key == names[k] && next != p)
+						{
+							*fields[k] = value;
+							found[k] = true;
+						}
+					}
+					p = next;
+				}
+
+				p = std::strchr(p, ',');
+				if (p == nullptr)
+				{
+					break;
+				}
+				p++;
+			}
+		}
+		else
+		{
+			// CSV, the type then the values in the order of the fields
+			const char* comma = std::strchr(p, ',');
+			if (comma == nullptr)
+			{
+				error = "malformed line";
+				return true;
+			}
+			type.assign(p, comma);
+			if (type == "type")
+			{
+				return false;
+			}
+
+			p = comma + 1;
+			for (int k = 0; k < 8; k++)
+			{
+				char* next;
+				*fields[k] = std::strtod(p, &next);
+				found[k] = (next != p);
+				p = next;
+				if (k < 7)
+				{
+					if (*p != ',')
+					{
+						break;
+					}
+					p++;
+				}
+			}
+		}
+
+		for (int k = 0; k < 8; k++)
+		{
+			if (!found[k])
+			{
+				error = std::string("missing or malformed field ") + names[k];
+				return true;
+			}
+		}
+
+		if (type != "call" && type != "put")
+		{
+			error = "the type must be call or put";
+			return true;
+		}
+		c.call = (type == "call");
+
+		return true;
+	}
+
+	void Batch::format(const std::vector<Contract>& contracts, const std::vector<std::string>& errors, int begin, int end, std::string& buffer) const
+	{
+		char record[128];
+
+		for (int i = begin; i < end; i++)
+		{
+			double values[3] = { 0, 0, 0 };
+			std::string error = errors[i];
+			bool ok = error.empty() && cache_.quote(contracts[i], values, error);
+
+			if (binary_)
+			{
+				record[0] = ok ? 0 : 1;
+				std::memcpy(record + 1, values, sizeof(values));
+				buffer.append(record, 1 + sizeof(values));
+			}
+			else if (ok)
+			{
+				int n = std::snprintf(record, sizeof(record), "%.17g,%.17g,%.17g,\n", values[0], values[1], values[2]);
+				buffer.append(record, n);
+			}
+			else
+			{
+				// The message can not contain the separator
+				for (char& ch : error)
+				{
+					ch = (ch == ',') ? ';' : ch;
+				}
+				buffer.append(",,," + error + "\n");
+			}
+		}
+	}
+
+	void Batch::run()
+	{
+		if (!binary_)
+		{
+			out_ << "price,delta,gamma,error\n";
+		}
+
+		unsigned int n_threads = threads_ ? threads_ : std::max(1u, std::thread::hardware_concurrency());
+		std::vector<Contract> contracts;
+		std::vector<std::string> errors;
+		std::vector<std::string> buffers(n_threads);
+		std::string line;
+		bool more = true;
+
+		while (more)
+		{
+			// Next chunk of contracts, the id of a stage being the one of its first contract
+			contracts.clear();
+			errors.clear();
+			{
+				Trace::Scope trace("parse", "batch", contracts_);
+				while ((int)contracts.size() < chunk_size_)
+				{
+					if (!std::getline(in_, line))
+					{
+						more = false;
+						break;
+					}
+					if (!line.empty() && line.back() == '\r')
+					{
+						line.pop_back();
+					}
+					if (line.find_first_not_of(" \t") == std::string::npos)
+					{
+						continue;
+					}
+
+					Contract c{ false, 0, 0, 0, 0, 0, 0, 0, 0 };
+					std::string error;
+					if (parse(line, c, error))
+					{
+						contracts.push_back(c);
+						errors.push_back(error);
+					}
+				}
+			}
+
+			int n = (int)contracts.size();
+			if (n == 0)
+			{
+				break;
+			}
+
+			std::vector<Contract> valid;
+			for (int i = 0; i < n; i++)
+			{
+				if (errors[i].empty())
+				{
+					valid.push_back(contracts[i]);
+				}
+			}
+			{
+				Trace::Scope trace("solve", "batch", contracts_);
+				cache_.solve(valid);
+			}
+
+			// Contiguous parts of the chunk formatted in parallel, then written in order
+			unsigned int parts = std::min(n_threads, (unsigned int)n);
+			std::vector<std::thread> threads;
+			for (unsigned int p = 0; p < parts; p++)
+			{
+				threads.emplace_back([&, p]()
+				{
+					int first = (int)((long long)n * p / parts);
+					Trace::Scope trace("format", "batch", contracts_ + first);
+					buffers[p].clear();
+					format(contracts, errors, first, (int)((long long)n * (p + 1) / parts), buffers[p]);
+				});
+			}
+
+			for (auto& th : threads)
+			{
+				th.join();
+			}
+
+			{
+				Trace::Scope trace("write", "batch", contracts_);
+				for (unsigned int p = 0; p < parts; p++)
+				{
+					out_.write(buffers[p].data(), buffers[p].size());
+				}
+			}
+			contracts_ += n;
+		}
+	}
+
+	long long Batch::get_contracts() const
+	{
+		return contracts_;
+	}
+
+	long long Batch::get_solves() const
+	{
+		return cache_.get_solves();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+#include "solvecache.h"
+#include <istream>
+#include <ostream>
+
+namespace ensiie
+{
+	/**
+	 * @class Batch
+	 * @brief A class to price a stream of contracts and write the results in the same order.
+	 *
+	 * @details
+	 * Each line of the input is a contract, either as CSV, `type,T,r,sigma,K,L,M,N,S` with a
+	 * type `call` or `put`, or as a JSON object with these keys, such as
+	 * `{"type": "call", "T": 1, "r": 0.05, "sigma": 0.2, "K": 100, "L": 400, "M": 200, "N": 400, "S": 105}`.
+	 * Blank lines and a CSV header starting with `type` are skipped.
+	 *
+	 * The output has one record per contract, in the order of the input:
+	 * - as CSV, a header then `price,delta,gamma,error`, the error being empty on success;
+	 * - in binary, a status byte, 0 on success, then price, delta and gamma as doubles in the
+	 *   byte order of the host.
+	 *
+	 * The contracts are read by chunks of `chunk_size` lines. The solves of a chunk are shared
+	 * and run in parallel by a `SolveCache`, then the records are formatted in parallel, each
+	 * thread writing a contiguous part of the chunk to its own buffer. The buffers are written
+	 * in order, with one write per chunk and no flush.
+	 */
+	class Batch
+	{
+		std::istream& in_; /**< Input stream of the contracts.*/
+		std::ostream& out_; /**< Output stream of the results.*/
+		bool binary_; /**< True for a binary output, false for CSV.*/
+		int chunk_size_; /**< Number of contracts read at once.*/
+		unsigned int threads_; /**< Number of threads, 0 for the number of hardware threads.*/
+		SolveCache cache_; /**< Solves of the contracts.*/
+		long long contracts_; /**< Number of contracts processed.*/
+
+		/**
+		 * @brief Parses a line of the input.
+		 *
+		 * @param line The line, in CSV or JSON.
+		 * @param c Overwritten with the contract.
+		 * @param error Overwritten with the error if the line is malformed.
+		 * @return True if the line is a contract, false otherwise.
+		 */
+		static bool parse(const std::string& line, Contract& c, std::string& error);
+
+		/**
+		 * @brief Formats the results of a part of a chunk.
+		 *
+		 * @param contracts Contracts of the chunk.
+		 * @param errors Parsing errors of the chunk, empty for the valid contracts.
+		 * @param begin First contract of the part.
+		 * @param end Contract following the last one of the part.
+		 * @param buffer Buffer the records are appended to.
+		 */
+		void format(const std::vector<Contract>& contracts, const std::vector<std::string>& errors, int begin, int end, std::string& buffer) const;
+
+	public:
+
+		/**
+		 * @brief Constructs a Batch object over two streams.
+		 *
+		 * @param in Input stream of the contracts.
+		 * @param out Output stream of the results, opened in binary mode for a binary output.
+		 * @param binary True for a binary output, false for CSV.
+		 * @param chunk_size Number of contracts read at once.
+		 *
+		 * @throws std::invalid_argument If `chunk_size` is not positive.
+		 */
+		Batch(std::istream& in, std::ostream& out, bool binary = false, int chunk_size = 16384);
+
+		/**
+		 * @brief Sets the number of threads.
+		 * @param threads Number of threads, 0 for the number of hardware threads.
+		 */
+		void set_threads(unsigned int threads);
+
+		/**
+		 * @brief Prices all the contracts of the input stream.
+		 */
+		void run();
+
+		/**
+		 * @brief Gets the number of contracts processed.
+		 * @return Number of contracts, including the invalid ones.
+		 */
+		long long get_contracts() const;
+
+		/**
+		 * @brief Gets the number of solves.
+		 * @return Number of solves, the other contracts being priced from a shared solve.
+		 */
+		long long get_solves() const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,294 @@
+#include "calibration.h"
+#include "trace.h"
+
+namespace ensiie
+{
+	Calibration::Calibration(double r, double S0, double M, double N, int max_iterations, double tolerance) : r_(r), S0_(S0), M_(M), N_(N), threads_(0), reduced_(false), max_iterations_(max_iterations), tolerance_(tolerance)
+	{
+		// Excpetion for negative values
+		if (r < 0 || S0 < 0 || M < 0 || N < 0 || max_iterations < 0 || tolerance < 0)
+		{
+			throw std::invalid_argument("Values must be non-negative");
+		}
+		// Exception for null parameters
+		else if (S0 == 0 || M == 0 || N == 0 || max_iterations == 0)
+		{
+			throw std::invalid_argument("S0, M, N and the maximum number of iterations must be positive");
+		}
+	}
+
+	void Calibration::add_quote(double T, double K, bool call, double price)
+	{
+		if (T <= 0 || K <= 0 || price < 0)
+		{
+			throw std::invalid_argument("T and K must be positive and the price non-negative");
+		}
+
+		quotes_.push_back({ T, K, call, price });
+	}
+
+	void Calibration::set_threads(unsigned int threads)
+	{
+		threads_ = threads;
+	}
+
+	void Calibration::set_reduced(bool reduced)
+	{
+		reduced_ = reduced;
+	}
+
+	std::vector<double> Calibration::model_prices(const Data& d, const std::vector<Quote>& quotes) const
+	{
+		// Put prices with strike S0 for every spot price of the grid
+		std::vector<double> put;
+		if (reduced_)
+		{
+			ReducedPut p(d);
+			p.set_scheme_theta(0.5);
+			p.pricing();
+			put = p.get_price();
+		}
+		else
+		{
+			CompletePut p(d);
+			p.set_threads(1);
+			p.pricing();
+			put = p.get_price();
+		}
+
+		std::vector<double> prices(quotes.size());
+		double ds = d.get_ds();
+		double discount = std::exp(-r_ * d.get_T());
+
+		for (int i = 0; i < (int)quotes.size(); i++)
+		{
+			// P(S0, K) = K / S0 P(S0^2 / K, S0), by linear interpolation
+			double x = S0_ * S0_ / quotes[i].K / ds;
+			int j = std::min((int)x, (int)d.get_N() - 1);
+			double w = x - j;
+			double p = quotes[i].K / S0_ * ((1 - w) * put[j] + w * put[j + 1]);
+
+			prices[i] = quotes[i].call ? p + S0_ - quotes[i].K * discount : p;
+		}
+
+		return prices;
+	}
+
+	double Calibration::domain(double T, double k_min, double k_max, double sigma) const
+	{
+		double L = std::max(S0_, S0_ * S0_ / k_min) * std::exp(r_ * T + 10 * sigma * std::sqrt(T));
+		return std::min(L, N_ / 10 * S0_ * S0_ / k_max);
+	}
+
+	void Calibration::fit(int k, const std::vector<Quote>& quotes, double sigma0)
+	{
+		double T = maturities_[k];
+
+		double k_min = quotes[0].K;
+		double k_max = quotes[0].K;
+		for (const Quote& q : quotes)
+		{
+			k_min = std::min(k_min, q.K);
+			k_max = std::max(k_max, q.K);
+		}
+
+		Data d(T, r_, sigma0, S0_, domain(T, k_min, k_max, sigma0), M_, N_);
+		int n = (int)quotes.size();
+
+		auto error = [&](const std::vector<double>& prices)
+		{
+			double sse = 0;
+			for (int i = 0; i < n; i++)
+			{
+				sse += (prices[i] - quotes[i].price) * (prices[i] - quotes[i].price);
+			}
+			return sse;
+		};
+
+		double sigma = sigma0;
+		double lambda = 1e-3;
+		std::vector<double> prices = model_prices(d, quotes);
+		double sse = error(prices);
+		int it = 0;
+
+		while (it < max_iterations_)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			// Grid rebuilt when the domain at the current volatility is longer than the grid, or
+			// less than half of it, the prices being those of the new grid
+			double L = domain(T, k_min, k_max, sigma);
+			if (L > d.get_L() || 2 * L < d.get_L())
+			{
+				d = Data(T, r_, sigma, S0_, L, M_, N_);
+				prices = model_prices(d, quotes);
+				sse = error(prices);
+			}
+
+			// Jacobian by a bumped solve on the same grid
+			double h = 1e-4 * sigma;
+			std::vector<double> bumped = model_prices(Data(d, r_, sigma + h), quotes);
+
+			double jtj = 0, jtr = 0;
+			for (int i = 0; i < n; i++)
+			{
+				double jac = (bumped[i] - prices[i]) / h;
+				jtj += jac * jac;
+				jtr += jac * (prices[i] - quotes[i].price);
+			}
+
+			if (jtj == 0)
+			{
+				break;
+			}
+
+			// Damped Gauss-Newton step, the damping growing until the error decreases
+			double step = 0;
+			bool accepted = false;
+			while (!accepted && lambda < 1e10)
+			{
+				step = -jtr / (jtj * (1 + lambda));
+				double trial = (sigma + step > 0) ? sigma + step : 0.5 * sigma;
+
+				std::vector<double> trial_prices = model_prices(Data(d, r_, trial), quotes);
+				double trial_sse = error(trial_prices);
+
+				if (trial_sse < sse)
+				{
+					step = trial - sigma;
+					sigma = trial;
+					prices = std::move(trial_prices);
+					sse = trial_sse;
+					lambda *= 0.1;
+					accepted = true;
+				}
+				else
+				{
+					lambda *= 10;
+				}
+			}
+
+			it++;
+			iteration_times_[k].push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+			// Converged only if the grid also covers the fitted volatility
+			if ((!accepted || std::fabs(step) <= tolerance_ * sigma) && domain(T, k_min, k_max, sigma) <= d.get_L())
+			{
+				break;
+			}
+		}
+
+		sigma_[k] = sigma;
+		rmse_[k] = std::sqrt(sse / n);
+		iterations_[k] = it;
+	}
+
+	void Calibration::calibrate(double sigma0)
+	{
+		if (quotes_.empty() || sigma0 <= 0)
+		{
+			throw std::invalid_argument("Quotes are required and sigma0 must be positive");
+		}
+
+		// Quotes grouped by maturity, in increasing order
+		std::map<double, std::vector<Quote>> groups;
+		for (const Quote& q : quotes_)
+		{
+			groups[q.T].push_back(q);
+		}
+
+		int n = (int)groups.size();
+		std::vector<std::vector<Quote>> quotes;
+		maturities_.clear();
+		for (auto& g : groups)
+		{
+			maturities_.push_back(g.first);
+			quotes.push_back(std::move(g.second));
+		}
+
+		sigma_.assign(n, 0);
+		rmse_.assign(n, 0);
+		iterations_.assign(n, 0);
+		iteration_times_.assign(n, std::vector<double>());
+
+		// The maturities are independent, they are shared between threads
+		unsigned int n_threads = threads_ ? threads_ : std::max(1u, std::thread::hardware_concurrency());
+		n_threads = std::min(n_threads, (unsigned int)n);
+
+		// The exception of a thread is kept and rethrown once all the threads are joined
+		std::vector<std::thread> threads;
+		std::vector<std::exception_ptr> errors(n_threads);
+		for (unsigned int p = 0; p < n_threads; p++)
+		{
+			threads.emplace_back([&, p]()
+			{
+				try
+				{
+					for (int k = p; k < n; k += n_threads)
+					{
+						Trace::Scope trace("fit", "calibration", k);
+						fit(k, quotes[k], sigma0);
+					}
+				}
+				catch (...)
+				{
+					errors[p] = std::current_exception();
+				}
+			});
+		}
+
+		for (auto& th : threads)
+		{
+			th.join();
+		}
+
+		for (const std::exception_ptr& error : errors)
+		{
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+
+		// Bootstrap of the piecewise constant volatility from the total variances
+		forward_sigma_.assign(n, 0);
+		double previous = 0, previous_T = 0;
+		for (int k = 0; k < n; k++)
+		{
+			double variance = sigma_[k] * sigma_[k] * maturities_[k];
+			forward_sigma_[k] = std::sqrt(std::max(0.0, (variance - previous) / (maturities_[k] - previous_T)));
+			previous = variance;
+			previous_T = maturities_[k];
+		}
+	}
+
+	const std::vector<double>& Calibration::get_maturities() const
+	{
+		return maturities_;
+	}
+
+	const std::vector<double>& Calibration::get_sigma() const
+	{
+		return sigma_;
+	}
+
+	const std::vector<double>& Calibration::get_forward_sigma() const
+	{
+		return forward_sigma_;
+	}
+
+	const std::vector<double>& Calibration::get_rmse() const
+	{
+		return rmse_;
+	}
+
+	const std::vector<int>& Calibration::get_iterations() const
+	{
+		return iterations_;
+	}
+
+	const std::vector<std::vector<double>>& Calibration::get_iteration_times() const
+	{
+		return iteration_times_;
+	}
+}
\ No newline at end of file
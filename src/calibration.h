@@ -0,0 +1,177 @@
+#pragma once
+#include "completeput.h"
+#include "reducedput.h"
+#include <map>
+#include <exception>
+
+namespace ensiie
+{
+	/**
+	 * @struct Quote
+	 * @brief Market price of a European option.
+	 */
+	struct Quote
+	{
+		double T; /**< Time to maturity.*/
+		double K; /**< Strike price.*/
+		bool call; /**< True for a call option, false for a put option.*/
+		double price; /**< Market price.*/
+	};
+
+	/**
+	 * @class Calibration
+	 * @brief A class to calibrate the volatility and its term structure to market prices.
+	 *
+	 * @details
+	 * For each maturity, the volatility is fitted to the quotes of this maturity by the
+	 * Levenberg-Marquardt algorithm, minimizing the sum of the squared price errors. The prices
+	 * are given by the `Complete` engine, or by the `Reduced` one with the Crank-Nicolson scheme.
+	 *
+	 * The prices being homogeneous in (S, K), P(S0, K) = K / S0 P(S0^2 / K, S0), a single put
+	 * solve with strike S0 gives the prices of all the strikes of a maturity, by interpolation
+	 * in its price vector, and the calls follow by put-call parity. The Jacobian costs one more
+	 * solve, with a bumped volatility on the same grid. The maturities are independent and
+	 * calibrated on separate threads. The domain of the solves covers ten standard deviations
+	 * at the current volatility, the grid being rebuilt when the volatility moves out of it.
+	 *
+	 * Since the prices of European options only depend on the integrated variance, the
+	 * piecewise constant volatility sigma(t) is then bootstrapped from the fitted volatilities:
+	 * sigma_k^2 (T_k - T_(k-1)) = sigma(T_k)^2 T_k - sigma(T_(k-1))^2 T_(k-1).
+	 */
+	class Calibration
+	{
+		double r_; /**< Market risk-free interest rate.*/
+		double S0_; /**< Spot price of the underlying asset.*/
+		double M_; /**< Number of time steps of the solves.*/
+		double N_; /**< Number of asset price steps of the solves.*/
+		unsigned int threads_; /**< Number of threads, 0 for the number of hardware threads.*/
+		bool reduced_; /**< Use of the `Reduced` engine instead of the `Complete` one.*/
+		int max_iterations_; /**< Maximum number of iterations for each maturity.*/
+		double tolerance_; /**< Relative tolerance on the volatility.*/
+		std::vector<Quote> quotes_; /**< Market quotes.*/
+		std::vector<double> maturities_; /**< Calibrated maturities, in increasing order.*/
+		std::vector<double> sigma_; /**< Fitted volatility of each maturity.*/
+		std::vector<double> forward_sigma_; /**< Piecewise constant volatility between the maturities.*/
+		std::vector<double> rmse_; /**< Root mean square price error of each maturity.*/
+		std::vector<int> iterations_; /**< Number of iterations of each maturity.*/
+		std::vector<std::vector<double>> iteration_times_; /**< Duration of each iteration of each maturity, in seconds.*/
+
+		/**
+		 * @brief Computes the model prices of the quotes of a maturity with a single solve.
+		 *
+		 * @param d A `Data` object with the maturity, the volatility and the grid of the solve.
+		 * @param quotes Quotes of the maturity.
+		 * @return A vector containing the model prices, in the order of the quotes.
+		 */
+		std::vector<double> model_prices(const Data& d, const std::vector<Quote>& quotes) const;
+
+		/**
+		 * @brief Computes the domain of the solves of a maturity.
+		 *
+		 * @param T Time to maturity.
+		 * @param k_min Lowest strike of the maturity.
+		 * @param k_max Highest strike of the maturity.
+		 * @param sigma Volatility of the solves.
+		 * @return Maximum asset price, covering the spot prices S0^2 / K up to ten standard deviations,
+		 * but short enough for the lowest of them to lie on the tenth node at least.
+		 */
+		double domain(double T, double k_min, double k_max, double sigma) const;
+
+		/**
+		 * @brief Fits the volatility of a maturity.
+		 *
+		 * @param k Index of the maturity.
+		 * @param quotes Quotes of the maturity.
+		 * @param sigma0 Initial volatility.
+		 */
+		void fit(int k, const std::vector<Quote>& quotes, double sigma0);
+
+	public:
+
+		/**
+		 * @brief Constructs a Calibration object with no quote.
+		 *
+		 * @param r Market Risk-free interest rate
+		 * @param S0 Spot price of the underlying asset
+		 * @param M Number of time steps of the solves
+		 * @param N Number of price steps of the solves
+		 * @param max_iterations Maximum number of iterations for each maturity
+		 * @param tolerance Relative tolerance on the volatility
+		 *
+		 * @throws std::invalid_argument If a parameter is negative, or if `S0`, `M`, `N` or
+		 * `max_iterations` is zero.
+		 */
+		Calibration(double r, double S0, double M, double N, int max_iterations = 50, double tolerance = 1e-8);
+
+		/**
+		 * @brief Adds a market quote.
+		 *
+		 * @param T Time to maturity
+		 * @param K Strike price
+		 * @param call True for a call option, false for a put option
+		 * @param price Market price
+		 *
+		 * @throws std::invalid_argument If `T` or `K` is not positive, or if `price` is negative.
+		 */
+		void add_quote(double T, double K, bool call, double price);
+
+		/**
+		 * @brief Sets the number of threads used for the maturities.
+		 * @param threads Number of threads, 0 for the number of hardware threads.
+		 */
+		void set_threads(unsigned int threads);
+
+		/**
+		 * @brief Sets the engine of the solves.
+		 * @param reduced True for the `Reduced` engine with the Crank-Nicolson scheme, false for the `Complete` one.
+		 */
+		void set_reduced(bool reduced);
+
+		/**
+		 * @brief Fits the volatility of each maturity and bootstraps the term structure.
+		 *
+		 * @param sigma0 Initial volatility of every maturity.
+		 * @throws std::invalid_argument If there is no quote or if `sigma0` is not positive.
+		 * @throws std::exception The first exception thrown by the fit of a maturity, once every
+		 * thread is joined.
+		 */
+		void calibrate(double sigma0 = 0.2);
+
+		/**
+		 * @brief Gets the calibrated maturities.
+		 * @return A vector of maturities, in increasing order.
+		 */
+		const std::vector<double>& get_maturities() const;
+
+		/**
+		 * @brief Gets the fitted volatilities.
+		 * @return A vector containing the constant volatility fitted to each maturity.
+		 */
+		const std::vector<double>& get_sigma() const;
+
+		/**
+		 * @brief Gets the piecewise constant volatility.
+		 * @return A vector whose k-th value is the volatility between the maturities k-1 and k,
+		 * 0 where the total variance decreases.
+		 */
+		const std::vector<double>& get_forward_sigma() const;
+
+		/**
+		 * @brief Gets the root mean square price errors.
+		 * @return A vector containing the error of each maturity.
+		 */
+		const std::vector<double>& get_rmse() const;
+
+		/**
+		 * @brief Gets the numbers of iterations.
+		 * @return A vector containing the number of iterations of each maturity.
+		 */
+		const std::vector<int>& get_iterations() const;
+
+		/**
+		 * @brief Gets the durations of the iterations.
+		 * @return For each maturity, a vector containing the duration of each iteration in seconds.
+		 */
+		const std::vector<std::vector<double>>& get_iteration_times() const;
+	};
+}
\ No newline at end of file
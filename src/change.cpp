@@ -1,94 +1,197 @@
-#include "change.h"
-
-namespace ensiie
-{
-	void Change::t_transformation()
-	{
-		double sigma_sqr = sigma_ * sigma_;
-		double dtau;
-		std::vector<double> tau(M_ + 1);
-
-		for (int i = 0; i <= M_; i++)
-		{
-			tau[M_ - i] = 0.5 * sigma_sqr * (T_ - t_[i]);
-		}
-
-		dtau = 0.5* sigma_sqr * dt_;
-
-		t_changed_ = tau;
-		dt_changed_ = dtau;
-	}
-
-	void Change::l_transformation()
-	{
-		double dx;
-		std::vector<double> x(N_ + 1, 0);
-
-		for (int i = 1; i <= N_; i++)
-		{
-			x[i] = std::log(l_[i] / K_);
-		}
-
-		///This aproximation is done as it's not possible to transform S=0
-		x[0] = x[1]; 
-
-		dx = (x[N_] - x[1]) / (N_ - 1);
-
-		l_changed_ = x;
-		ds_changed_ = dx;
-	}
-
-	std::vector<double> Change::price_transformation(const std::vector<double>& v)
-	{
-		std::vector<double> correct_price(N_ + 1);
-		std::vector<double> coefficient(N_ + 1);
-
-		///It's taken into account just the change of variable for the final time
-		for (int i = 0; i <= N_; i++)
-		{
-			coefficient[i] = K_ * exp(-0.5 * (f_ - 1) * l_changed_[i]);
-			correct_price[i] = v[i] * coefficient[i];
-		}
-
-		return correct_price;
-	};
-
-	Change::Change(double T, double r, double sigma, double K, double L, double M, double N) : Data(T, r, sigma, K, L, M, N)
-	{
-		t_transformation();
-		l_transformation();
-		f_ = 2 * r / (sigma * sigma);
-	}
-
-	Change::Change(const Data& d) : Data(d)
-	{
-		t_transformation();
-		l_transformation();
-		f_ = 2 * r_ / (sigma_ * sigma_);
-	}
-
-	std::vector<double> Change::get_t_changed() const
-	{
-		return t_changed_;
-	}
-
-	std::vector<double> Change::get_l_changed() const
-	{
-		return l_changed_;
-	}
-
-	double Change::get_dt_changed() const
-	{
-		return dt_changed_;
-	}
-
-	double Change::get_ds_changed() const
-	{
-		return ds_changed_;
-	}
-
-	double Change::get_f() const
-	{
-		return f_;
-	}
+#include "change.h"
+#include "workspace.h"
+#include "profile.h"
+#include "vmath.h"
+#include <algorithm>
+
+namespace ensiie
+{
+	void Change::t_transformation()
+	{
+		ENSIIE_PROFILE_SCOPE(t_transformation, M_ + 1);
+		double sigma_sqr = sigma_ * sigma_;
+		double dtau;
+		std::vector<double> tau(M_ + 1);
+
+		for (int i = 0; i <= M_; i++)
+		{
+			tau[M_ - i] = 0.5 * sigma_sqr * (T_ - t_[i]);
+		}
+
+		dtau = 0.5* sigma_sqr * dt_;
+
+		t_changed_ = std::move(tau);
+		dt_changed_ = dtau;
+	}
+
+	void Change::l_transformation()
+	{
+		ENSIIE_PROFILE_SCOPE(l_transformation, N_ + 1);
+		std::vector<double> x(N_ + 1);
+
+		if (N_ < 3)
+		{
+			throw std::invalid_argument("N must be at least 3 to interpolate the transformed prices");
+		}
+
+		///S=0 can't be transformed, the grid starts at the first positive node
+		double x_min = std::log(l_[1] / K_);
+		double x_max = std::log(L_ / K_);
+		double dx = (x_max - x_min) / N_;
+
+		for (int i = 0; i <= N_; i++)
+		{
+			x[i] = x_min + i * dx;
+		}
+		moneyness_.resize(N_ + 1);
+		vector_exp(x.data(), moneyness_.data(), moneyness_.size());
+
+		///Positions of the nodes of l_ on the uniform grid, for the interpolation back
+		std::vector<double> position(N_ + 1, 0);
+		for (int i = 1; i <= N_; i++)
+		{
+			position[i] = l_[i] / K_;
+		}
+		vector_log(position.data() + 1, position.data() + 1, (std::size_t)N_);
+
+		stencil_.assign(N_ + 1, 0);
+		coefficients_.assign(4 * (N_ + 1), 0);
+		for (int i = 1; i <= N_; i++)
+		{
+			double p = (position[i] - x_min) / dx;
+			int k = std::min(std::max((int)std::floor(p), 1), (int)N_ - 2);
+			double q = p - k;
+
+			/// Cubic Lagrange interpolation on the nodes k-1, k, k+1 and k+2
+			stencil_[i] = k - 1;
+			coefficients_[4 * i] = -q * (q - 1) * (q - 2) / 6;
+			coefficients_[4 * i + 1] = (q + 1) * (q - 1) * (q - 2) / 2;
+			coefficients_[4 * i + 2] = -(q + 1) * q * (q - 2) / 2;
+			coefficients_[4 * i + 3] = (q + 1) * q * (q - 1) / 6;
+		}
+
+		l_changed_ = std::move(x);
+		ds_changed_ = dx;
+	}
+
+	void Change::weight_computation()
+	{
+		std::vector<double> w(N_ + 1);
+
+		for (int i = 0; i <= N_; i++)
+		{
+			w[i] = 0.5 * (f_ - 1) * l_changed_[i];
+		}
+		vector_exp(w.data(), w.data(), w.size());
+
+		weight_ = std::move(w);
+	}
+
+	void Change::growth_computation()
+	{
+		std::vector<double> g(M_ + 1);
+		std::vector<double> h(M_ + 1);
+
+		for (int i = 0; i <= M_; i++)
+		{
+			g[i] = 0.25 * (f_ + 1) * (f_ + 1) * t_changed_[i];
+			h[i] = 0.25 * (f_ - 1) * (f_ - 1) * t_changed_[i];
+		}
+		vector_exp(g.data(), g.data(), g.size());
+		vector_exp(h.data(), h.data(), h.size());
+
+		growth_ = std::move(g);
+		discounted_growth_ = std::move(h);
+	}
+
+	double Change::growth(double tau) const
+	{
+		long i = (dt_changed_ > 0) ? std::lround(tau / dt_changed_) : 0;
+
+		if (i >= 0 && i <= M_ && t_changed_[i] == tau)
+		{
+			return growth_[i];
+		}
+
+		return std::exp(0.25 * (f_ + 1) * (f_ + 1) * tau);
+	}
+
+	double Change::discounted_growth(double tau) const
+	{
+		long i = (dt_changed_ > 0) ? std::lround(tau / dt_changed_) : 0;
+
+		if (i >= 0 && i <= M_ && t_changed_[i] == tau)
+		{
+			return discounted_growth_[i];
+		}
+
+		return std::exp(0.25 * (f_ - 1) * (f_ - 1) * tau);
+	}
+
+	void Change::price_transformation(std::vector<double>& v, double tau) const
+	{
+		ENSIIE_PROFILE_SCOPE(price_transformation, N_ + 1);
+		PricingWorkspace& workspace = PricingWorkspace::local();
+		PricingWorkspace::Scope scope(workspace);
+		std::vector<double>& u = workspace.acquire(N_ + 1);
+
+		///Prices on the transformed grid, with the factor of the change of time
+		double decay = K_ / growth(tau);
+		for (int i = 0; i <= N_; i++)
+		{
+			u[i] = v[i] * decay / weight_[i];
+		}
+
+		///Interpolation on the asset price grid
+		for (int i = 1; i <= N_; i++)
+		{
+			const double* c = &coefficients_[4 * i];
+			const double* w = &u[stencil_[i]];
+			v[i] = c[0] * w[0] + c[1] * w[1] + c[2] * w[2] + c[3] * w[3];
+		}
+		v[0] = 2 * v[1] - v[2];
+	};
+
+	Change::Change(double T, double r, double sigma, double K, double L, double M, double N) : Data(T, r, sigma, K, L, M, N)
+	{
+		t_transformation();
+		l_transformation();
+		f_ = 2 * r / (sigma * sigma);
+		weight_computation();
+		growth_computation();
+	}
+
+	Change::Change(const Data& d) : Data(d)
+	{
+		t_transformation();
+		l_transformation();
+		f_ = 2 * r_ / (sigma_ * sigma_);
+		weight_computation();
+		growth_computation();
+	}
+
+	const std::vector<double>& Change::get_t_changed() const
+	{
+		return t_changed_;
+	}
+
+	const std::vector<double>& Change::get_l_changed() const
+	{
+		return l_changed_;
+	}
+
+	double Change::get_dt_changed() const
+	{
+		return dt_changed_;
+	}
+
+	double Change::get_ds_changed() const
+	{
+		return ds_changed_;
+	}
+
+	double Change::get_f() const
+	{
+		return f_;
+	}
 }
\ No newline at end of file
@@ -1,115 +1,166 @@
-#pragma once
-#include "data.h"
-#include <cmath>
-
-namespace ensiie
-{
-	/**
-	 * @class Change
-	 * 
-	 * @brief Class representing a transformation of variables to determine those to be used to 
-	 * dtermine the transformed PDE solution to the otpion pricing.
-	 *
-	 * The `Change` class inherits from the `Data` class and is responsible for performing
-	 * transformation of prices and time vectors.
-	 */
-	class Change : public Data
-	{
-	protected:
-		double f_; /**< Parameter to execute variable's change.*/
-		double dt_changed_; /**< Changed time step.*/
-		double ds_changed_; /**< Changed underlying asset's price step.*/
-		std::vector<double> t_changed_;
-		std::vector<double> l_changed_;
-
-		/**
-		 * @brief Performs the time transformation.
-		 *
-		 * This function calculates the time transformation `t` based on volatility
-		 * and maturity, and stores the results in `t_changed_` and `dt_changed_`.
-		 */
-		void t_transformation();
-
-		/**
-		 * @brief Performs the price transformation.
-		 *
-		 * This function calculates the price transformation `l` based on the parameter `K`
-		 * and stores the results in `l_changed_` and `ds_changed_`.
-		 */
-		void l_transformation();
-
-		/**
-		* @brief Transforms the t=0 price vector.
-		*
-		* @param v The price vector to be transformed.
-		* @return A vector containing the transformed prices.
-		*
-		* This function applies a transformation to the prices obtained by the changed PDE using 
-		* a formula based on `f_` and `l_changed_`, returning a vector with the corrected prices.
-		*/
-		std::vector<double> price_transformation(const std::vector<double>& v);
-
-	public:
-
-		/**
-		* @brief Constructs a Change object using financial parameters.
-		*
-		* Initializes the financial parameters for the option pricing model and
-		* calculates transofrmation of time and underlying asset's price.
-		*
-		* @param T Time to maturity (in years)
-		* @param r Market Risk-free interest rate
-		* @param sigma Volatility of the underlying asset
-		* @param K Strike price of the option
-		* @param L Maximum value of the underlying asset
-		* @param M Number of time steps
-		* @param N Number of price steps
-		*/
-		Change(double T, double r, double sigma, double K, double L, double M, double N);
-
-		/**
-		* @brief Constructs a Reduced object using an existing Data object.
-		 *
-		 * This constructor initializes the model using an existing `Data` object
-		 * and calculates change of variables.
-		 *
-		 * @param d A `Data` object containing the financial parameters for the model
-		*/
-		Change(const Data& d);
-
-		/**
-		 * @brief Gets the transformed time values.
-		 *
-		 * @return A vector containing the transformed time values.
-		 */
-		std::vector<double> get_t_changed() const;
-
-		/**
-		 * @brief Gets the transformed price values.
-		 *
-		 * @return A vector containing the transformed asset's price values.
-		 */
-		std::vector<double> get_l_changed() const;
-
-		/**
-		 * @brief Gets the time variation step.
-		 *
-		 * @return The time variation step.
-		 */
-		double get_dt_changed() const;
-
-		/**
-		 * @brief Gets the price variation.
-		 *
-		 * @return The price variation value.
-		 */
-		double get_ds_changed() const;
-
-		/**
-		 * @brief Gets the f parameter.
-		 *
-		 * @return The f parameter value.
-		 */
-		double get_f() const;
-	};
+#pragma once
+#include "data.h"
+#include <cmath>
+
+namespace ensiie
+{
+	/**
+	 * @class Change
+	 * 
+	 * @brief Class representing a transformation of variables to determine those to be used to 
+	 * dtermine the transformed PDE solution to the otpion pricing.
+	 *
+	 * The `Change` class inherits from the `Data` class and is responsible for performing
+	 * transformation of prices and time vectors.
+	 */
+	class Change : public Data
+	{
+	protected:
+		double f_; /**< Parameter to execute variable's change.*/
+		double dt_changed_; /**< Changed time step.*/
+		double ds_changed_; /**< Changed underlying asset's price step.*/
+		std::vector<double> t_changed_;
+		std::vector<double> l_changed_;
+		std::vector<double> weight_; /**< Factors e^((f-1)x/2) of the change of the prices.*/
+		std::vector<double> moneyness_; /**< Ratios e^x = s/K of the nodes of `l_changed_`.*/
+		std::vector<double> growth_; /**< Factors e^((f+1)^2 tau/4) of the change of time, on `t_changed_`.*/
+		std::vector<double> discounted_growth_; /**< Factors e^(-f tau) e^((f+1)^2 tau/4) = e^((f-1)^2 tau/4), on `t_changed_`.*/
+		std::vector<int> stencil_; /**< First node of `l_changed_` used to interpolate the price at each node of `l_`.*/
+		std::vector<double> coefficients_; /**< Four Lagrange coefficients of the interpolation for each node of `l_`.*/
+
+		/**
+		 * @brief Performs the time transformation.
+		 *
+		 * This function calculates the time transformation `t` based on volatility
+		 * and maturity, and stores the results in `t_changed_` and `dt_changed_`.
+		 */
+		void t_transformation();
+
+		/**
+		 * @brief Performs the price transformation.
+		 *
+		 * The grid `l_changed_` is uniform in x = log(s/K), from the first positive node ds
+		 * of `l_` to L, with N steps of `ds_changed_`: the finite differences of the modified
+		 * PDE need a constant step in x, which the logarithms of the nodes of `l_` do not have.
+		 * The cubic Lagrange interpolation from this grid back to the nodes of `l_` is
+		 * computed once, in `stencil_` and `coefficients_`.
+		 */
+		void l_transformation();
+
+		/**
+		 * @brief Computes the factors of the change of the prices.
+		 *
+		 * The factors e^((f-1)x/2) of the grid `l_changed_` are computed once by a vectorized
+		 * exponential, then shared by the terminal conditions and `price_transformation()`.
+		 */
+		void weight_computation();
+
+		/**
+		 * @brief Computes the factors of the change of time on the grid `t_changed_`.
+		 *
+		 * The factors `growth_` and `discounted_growth_` are computed once by a vectorized
+		 * exponential, then shared by the boundary conditions and `price_transformation()`.
+		 */
+		void growth_computation();
+
+		/**
+		 * @brief Gets the factor e^((f+1)^2 tau/4) of the change of time.
+		 *
+		 * The factors of the dates of `t_changed_` are read from `growth_`, the others are
+		 * computed on the fly.
+		 *
+		 * @param tau Transformed time.
+		 * @return The factor e^((f+1)^2 tau/4).
+		 */
+		double growth(double tau) const;
+
+		/**
+		 * @brief Gets the discounted factor e^(-f tau) e^((f+1)^2 tau/4) of the change of time.
+		 *
+		 * e^(-f tau) being the discount factor e^(-r(T-t)), this is the factor of the terms of
+		 * the boundary conditions proportional to K. It is read from `discounted_growth_` on
+		 * the dates of `t_changed_`.
+		 *
+		 * @param tau Transformed time.
+		 * @return The factor e^((f-1)^2 tau/4).
+		 */
+		double discounted_growth(double tau) const;
+
+		/**
+		* @brief Transforms a layer of modified prices back to prices, in place.
+		*
+		* @param v The modified prices on `l_changed_`, overwritten with the prices on `l_`.
+		* @param tau Transformed time of the layer, `t_changed_[M]` for the prices at t=0.
+		*
+		* The prices are K e^(-(f-1)x/2 - (f+1)^2 tau/4) u on the grid `l_changed_`, from the
+		* precomputed factors `weight_` and `growth()`, and are interpolated on the nodes of `l_`. The price
+		* for s=0, which has no transformed node, is extrapolated linearly from s=ds and s=2ds.
+		* The scratch vector comes from the workspace of the thread, so no memory is allocated
+		* once the workspace has seen the grid.
+		*/
+		void price_transformation(std::vector<double>& v, double tau) const;
+
+	public:
+
+		/**
+		* @brief Constructs a Change object using financial parameters.
+		*
+		* Initializes the financial parameters for the option pricing model and
+		* calculates transofrmation of time and underlying asset's price.
+		*
+		* @param T Time to maturity (in years)
+		* @param r Market Risk-free interest rate
+		* @param sigma Volatility of the underlying asset
+		* @param K Strike price of the option
+		* @param L Maximum value of the underlying asset
+		* @param M Number of time steps
+		* @param N Number of price steps
+		*/
+		Change(double T, double r, double sigma, double K, double L, double M, double N);
+
+		/**
+		* @brief Constructs a Reduced object using an existing Data object.
+		 *
+		 * This constructor initializes the model using an existing `Data` object
+		 * and calculates change of variables.
+		 *
+		 * @param d A `Data` object containing the financial parameters for the model
+		*/
+		Change(const Data& d);
+
+		/**
+		 * @brief Gets the transformed time values.
+		 *
+		 * @return A vector containing the transformed time values.
+		 */
+		const std::vector<double>& get_t_changed() const;
+
+		/**
+		 * @brief Gets the transformed price values.
+		 *
+		 * @return A vector containing the transformed asset's price values, uniform in x = log(s/K).
+		 */
+		const std::vector<double>& get_l_changed() const;
+
+		/**
+		 * @brief Gets the time variation step.
+		 *
+		 * @return The time variation step.
+		 */
+		double get_dt_changed() const;
+
+		/**
+		 * @brief Gets the price variation.
+		 *
+		 * @return The price variation value.
+		 */
+		double get_ds_changed() const;
+
+		/**
+		 * @brief Gets the f parameter.
+		 *
+		 * @return The f parameter value.
+		 */
+		double get_f() const;
+	};
 }
\ No newline at end of file
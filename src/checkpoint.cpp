@@ -0,0 +1,138 @@
+#include "checkpoint.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace ensiie
+{
+	static const char checkpoint_magic[8] = { 'B', 'S', 'P', 'D', 'E', 'C', 'K', 'P' };
+	static const std::uint32_t checkpoint_byte_order = 0x01020304;
+
+	Checkpoint::Checkpoint(const std::string& path, int interval) : path_(path), interval_(interval), saves_(0), overhead_(0), resumed_step_(0)
+	{
+		if (path.empty() || interval <= 0)
+		{
+			throw std::invalid_argument("The path must be non-empty and the interval positive");
+		}
+	}
+
+	void Checkpoint::fill_header(const Data& d, const std::string& kind, int step, CheckpointHeader& header)
+	{
+		std::memset(&header, 0, sizeof(header));
+		std::memcpy(header.magic, checkpoint_magic, sizeof(checkpoint_magic));
+		header.version = version;
+		header.byte_order = checkpoint_byte_order;
+		header.step = step;
+		header.nodes = (std::uint64_t)d.get_N() + 1;
+		header.T = d.get_T();
+		header.r = d.get_r();
+		header.sigma = d.get_sigma();
+		header.K = d.get_K();
+		header.L = d.get_L();
+		header.M = d.get_M();
+		std::strncpy(header.kind, kind.c_str(), sizeof(header.kind) - 1);
+	}
+
+	bool Checkpoint::restore(const Data& d, const std::string& kind, int& step, std::vector<double>& v)
+	{
+		resumed_step_ = 0;
+
+		std::FILE* file = std::fopen(path_.c_str(), "rb");
+		if (!file)
+		{
+			return false;
+		}
+
+		// Everything but the step must match the solve, byte for byte
+		CheckpointHeader expected, header;
+		fill_header(d, kind, 0, expected);
+		bool ok = std::fread(&header, sizeof(header), 1, file) == 1;
+		if (ok)
+		{
+			expected.step = header.step;
+			ok = std::memcmp(&header, &expected, sizeof(header)) == 0 && header.step > 0 && header.step <= (std::int64_t)d.get_M();
+		}
+
+		std::vector<double> layer;
+		if (ok)
+		{
+			layer.resize(header.nodes);
+			ok = std::fread(layer.data(), sizeof(double), layer.size(), file) == layer.size();
+		}
+		std::fclose(file);
+
+		if (!ok)
+		{
+			return false;
+		}
+
+		step = (int)header.step;
+		v.swap(layer);
+		resumed_step_ = step;
+		return true;
+	}
+
+	bool Checkpoint::due(int step) const
+	{
+		return step % interval_ == 0;
+	}
+
+	void Checkpoint::save(const Data& d, const std::string& kind, int step, const std::vector<double>& v)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		CheckpointHeader header;
+		fill_header(d, kind, step, header);
+
+		std::string temporary = path_ + ".tmp";
+		std::FILE* file = std::fopen(temporary.c_str(), "wb");
+		if (!file)
+		{
+			throw std::runtime_error("The checkpoint file " + temporary + " can not be created");
+		}
+
+		bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+		ok = ok && std::fwrite(v.data(), sizeof(double), v.size(), file) == v.size();
+		ok = (std::fclose(file) == 0) && ok;
+
+		// The rename replaces the previous checkpoint at once, except where it can not overwrite a file
+		if (ok && std::rename(temporary.c_str(), path_.c_str()) != 0)
+		{
+			std::remove(path_.c_str());
+			ok = std::rename(temporary.c_str(), path_.c_str()) == 0;
+		}
+		if (!ok)
+		{
+			std::remove(temporary.c_str());
+			throw std::runtime_error("The checkpoint file " + path_ + " can not be written");
+		}
+
+		saves_++;
+		overhead_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void Checkpoint::clear()
+	{
+		std::remove(path_.c_str());
+	}
+
+	int Checkpoint::get_interval() const
+	{
+		return interval_;
+	}
+
+	int Checkpoint::get_saves() const
+	{
+		return saves_;
+	}
+
+	double Checkpoint::get_overhead() const
+	{
+		return overhead_;
+	}
+
+	int Checkpoint::get_resumed_step() const
+	{
+		return resumed_step_;
+	}
+}
\ No newline at end of file
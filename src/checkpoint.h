@@ -0,0 +1,138 @@
+#pragma once
+#include "data.h"
+#include <cstdint>
+#include <string>
+
+namespace ensiie
+{
+	/**
+	 * @struct CheckpointHeader
+	 * @brief Header of a checkpoint file, followed by the N+1 values of the saved layer.
+	 */
+	struct CheckpointHeader
+	{
+		char magic[8]; /**< "BSPDECKP".*/
+		std::uint32_t version; /**< Version of the format.*/
+		std::uint32_t byte_order; /**< 0x01020304 in the byte order of the writer.*/
+		std::int64_t step; /**< Number of time steps done to reach the saved layer.*/
+		std::uint64_t nodes; /**< Number of values of the layer, N+1.*/
+		double T; /**< Time to maturity.*/
+		double r; /**< Market risk-free interest rate.*/
+		double sigma; /**< Underlying asset volatility.*/
+		double K; /**< Strike price of the option.*/
+		double L; /**< Underlying asset maximum price.*/
+		double M; /**< Number of time steps.*/
+		char kind[64]; /**< Engine and scheme of the solve, zero-terminated.*/
+	};
+
+	static_assert(sizeof(CheckpointHeader) == 144, "The checkpoint header must be 144 bytes long");
+
+	/**
+	 * @class Checkpoint
+	 * @brief A class to save the current layer of a long sweep and to resume from it.
+	 *
+	 * @details
+	 * An engine given the checkpoint with `set_checkpoint()` saves its layer and the number
+	 * of steps done every `interval` steps. The file is written to a temporary file which then
+	 * replaces the previous checkpoint, so that an interruption during the save leaves the
+	 * last complete one. At the start of the next sweep, a checkpoint of the same solve, with
+	 * the same parameters, engine and scheme, is loaded and the sweep continues after its
+	 * step; a checkpoint of another solve is ignored and replaced. The file is removed once
+	 * the sweep completes.
+	 *
+	 * Only one layer is saved, so a save costs the writing of 8(N+1) bytes. The time spent
+	 * in the saves is accumulated, to measure the overhead of an interval.
+	 */
+	class Checkpoint
+	{
+		std::string path_; /**< Path of the checkpoint file.*/
+		int interval_; /**< Number of time steps between two saves.*/
+		int saves_; /**< Number of saves done.*/
+		double overhead_; /**< Time spent in the saves, in seconds.*/
+		int resumed_step_; /**< Step of the last checkpoint loaded, 0 if none.*/
+
+		/**
+		 * @brief Fills a header for a solve.
+		 *
+		 * @param d A `Data` object containing the parameters of the solve.
+		 * @param kind Engine and scheme of the solve.
+		 * @param step Number of time steps done.
+		 * @param header Header, overwritten.
+		 */
+		static void fill_header(const Data& d, const std::string& kind, int step, CheckpointHeader& header);
+
+	public:
+
+		static const std::uint32_t version = 1; /**< Version of the format written.*/
+
+		/**
+		 * @brief Constructs a Checkpoint object.
+		 *
+		 * @param path Path of the checkpoint file.
+		 * @param interval Number of time steps between two saves.
+		 *
+		 * @throws std::invalid_argument If `path` is empty or `interval` is not positive.
+		 */
+		Checkpoint(const std::string& path, int interval);
+
+		/**
+		 * @brief Loads the checkpoint of a solve, if any.
+		 *
+		 * @param d A `Data` object containing the parameters of the solve.
+		 * @param kind Engine and scheme of the solve.
+		 * @param step Number of time steps done to reach the loaded layer.
+		 * @param v Layer, overwritten with the N+1 saved values.
+		 * @return True if a checkpoint of this solve was loaded, false otherwise.
+		 */
+		bool restore(const Data& d, const std::string& kind, int& step, std::vector<double>& v);
+
+		/**
+		 * @brief Tells whether a save is due after a step.
+		 *
+		 * @param step Number of time steps done.
+		 * @return True every `interval` steps.
+		 */
+		bool due(int step) const;
+
+		/**
+		 * @brief Saves a layer, replacing the previous checkpoint.
+		 *
+		 * @param d A `Data` object containing the parameters of the solve.
+		 * @param kind Engine and scheme of the solve.
+		 * @param step Number of time steps done to reach the layer.
+		 * @param v Layer of N+1 values.
+		 *
+		 * @throws std::runtime_error If the file can not be written.
+		 */
+		void save(const Data& d, const std::string& kind, int step, const std::vector<double>& v);
+
+		/**
+		 * @brief Removes the checkpoint file, the solve being complete.
+		 */
+		void clear();
+
+		/**
+		 * @brief Gets the number of time steps between two saves.
+		 * @return The interval.
+		 */
+		int get_interval() const;
+
+		/**
+		 * @brief Gets the number of saves done.
+		 * @return Number of saves.
+		 */
+		int get_saves() const;
+
+		/**
+		 * @brief Gets the time spent in the saves.
+		 * @return Time in seconds.
+		 */
+		double get_overhead() const;
+
+		/**
+		 * @brief Gets the step from which the last sweep resumed.
+		 * @return Number of time steps loaded from the checkpoint, 0 if the sweep started from T.
+		 */
+		int get_resumed_step() const;
+	};
+}
\ No newline at end of file
@@ -1,85 +1,915 @@
-#include "complete.h"
-
-namespace ensiie
-{
-	void Complete::coefficients_computation()
-	{
-		std::vector<double> alpha(N_ + 1), beta(N_ + 1), gamma(N_ + 1);
-
-		double sigma_sqr = sigma_ * sigma_;
-
-		for (int i = 0; i <= N_; i++)
-		{
-			double i_sqr = i * i;
-
-			alpha[i] = (dt_ / 4) * ((sigma_sqr * i_sqr) - (r_ * i));
-		
-			beta[i] = (-dt_ / 2) * ((sigma_sqr * i_sqr) + r_);
-		
-			gamma[i] = (dt_ / 4) * ((sigma_sqr * i_sqr) + (r_ * i));
-		}
-
-		alpha_ = alpha;
-		beta_ = beta;
-		gamma_ = gamma;
-	}
-
-	void Complete::lu_factorization()
-	{
-		std::vector<double> low(N_ + 1, 0), up(N_ + 1, 0);
-
-		for (int i = 0; i <= N_; i++)
-		{
-			if (i == 0)
-			{
-				up[i] = 1 - beta_[i];
-				low[i] = 0;
-			}
-			else
-			{
-				low[i] = -(alpha_[i]) / up[i - 1];
-				up[i] = (1 - beta_[i]) + low[i] * (gamma_[i-1]);
-			}
-		}
-
-		low_ = low;
-		up_ = up;
-	}
-
-	Complete::Complete(double T, double r, double sigma, double K, double L, double M, double N) : Data(T, r, sigma, K, L, M, N)
-	{
-		coefficients_computation();
-		lu_factorization();
-	}
-
-	Complete::Complete(const Data& d) : Data(d)
-	{
-		coefficients_computation();
-		lu_factorization();
-	}
-
-	std::vector<double> Complete::get_alpha() const
-	{
-		return alpha_;
-	}
-
-	std::vector<double> Complete::get_beta() const
-	{
-		return beta_;
-	}
-
-	std::vector<double> Complete::get_gamma() const
-	{
-		return gamma_;
-	}
-
-	std::vector<double> Complete::get_low() const
-	{
-		return low_;
-	}
-
-	std::vector<double> Complete::get_up() const
-	{
-		return up_;
-	}
+#include "complete.h"
+#include "profile.h"
+#include "trace.h"
+
+namespace ensiie
+{
+	void Complete::coefficients_computation()
+	{
+		ENSIIE_PROFILE_SCOPE(coefficients_computation, N_ + 1);
+		std::vector<double> alpha(N_ + 1), beta(N_ + 1), gamma(N_ + 1);
+		std::vector<double> mass_low(N_ + 1, 0), mass_diag(N_ + 1, 1), mass_up(N_ + 1, 0);
+
+		double sigma_sqr = sigma_ * sigma_;
+
+		// Correction of the diffusion coefficient for the compact scheme
+		double kappa = (r_ + sigma_sqr) / 12 - (2 * sigma_sqr - r_) * (sigma_sqr + r_) / (6 * sigma_sqr);
+
+		for (int i = 0; i <= N_; i++)
+		{
+			double i_sqr = (double)i * i;
+
+			alpha[i] = (dt_ / 4) * ((sigma_sqr * i_sqr) - (r_ * i));
+		
+			beta[i] = (-dt_ / 2) * ((sigma_sqr * i_sqr) + r_);
+		
+			gamma[i] = (dt_ / 4) * ((sigma_sqr * i_sqr) + (r_ * i));
+
+			// The boundary rows keep the central scheme
+			if (compact_ && i > 0 && i < N_)
+			{
+				double m = (2 * sigma_sqr - r_) / (12 * sigma_sqr * i);
+
+				alpha[i] += (dt_ / 2) * kappa;
+				beta[i] -= dt_ * kappa;
+				gamma[i] += (dt_ / 2) * kappa;
+
+				mass_low[i] = 1.0 / 12 + m;
+				mass_diag[i] = 10.0 / 12;
+				mass_up[i] = 1.0 / 12 - m;
+			}
+		}
+
+		alpha_ = std::move(alpha);
+		beta_ = std::move(beta);
+		gamma_ = std::move(gamma);
+		mass_low_ = std::move(mass_low);
+		mass_diag_ = std::move(mass_diag);
+		mass_up_ = std::move(mass_up);
+	}
+
+	void Complete::lu_factorization()
+	{
+		factorization(1, low_, up_);
+	}
+
+	void Complete::factorization(double scale, std::vector<double>& low, std::vector<double>& up) const
+	{
+		ENSIIE_PROFILE_SCOPE(lu_factorization, N_ + 1);
+		low.assign(N_ + 1, 0);
+		up.assign(N_ + 1, 0);
+
+		for (int i = 0; i <= N_; i++)
+		{
+			if (i == 0)
+			{
+				up[i] = mass_diag_[i] - scale * beta_[i];
+				low[i] = 0;
+			}
+			else
+			{
+				low[i] = (mass_low_[i] - scale * alpha_[i]) / up[i - 1];
+				up[i] = (mass_diag_[i] - scale * beta_[i]) - low[i] * (mass_up_[i - 1] - scale * gamma_[i - 1]);
+			}
+		}
+	}
+
+	void Complete::crank_nicolson(std::vector<double>& v, double scale, const std::vector<double>& low, const std::vector<double>& up,
+		double lower, double upper, std::vector<double>& b, std::vector<double>& y) const
+	{
+		if (pool_)
+		{
+			parallel_crank_nicolson(v, scale, low, up, lower, upper, b, y, *pool_);
+			return;
+		}
+
+		// Solution to the problem Ly=b, comuting b and then y
+		{
+			ENSIIE_PROFILE_SCOPE(forward_sweep, N_ + 1);
+			for (int j = 0; j <= N_; j++)
+			{
+				if (j == 0)
+				{
+					b[j] = v[j] * (mass_diag_[j] + scale * beta_[j]) + v[j + 1] * (mass_up_[j] + scale * gamma_[j]);
+					y[j] = b[j];
+				}
+				else if (j == N_)
+				{
+					b[j] = v[j] * (mass_diag_[j] + scale * beta_[j]) + v[j - 1] * (mass_low_[j] + scale * alpha_[j]);
+					y[j] = b[j] - low[j] * y[j - 1];
+				}
+				else
+				{
+					b[j] = v[j] * (mass_diag_[j] + scale * beta_[j]) + v[j + 1] * (mass_up_[j] + scale * gamma_[j]) + v[j - 1] * (mass_low_[j] + scale * alpha_[j]);
+					y[j] = b[j] - low[j] * y[j - 1];
+				}
+			}
+		}
+
+		// Boundary conditions for s=0 and s=L
+		v[0] = lower;
+		v[N_] = upper;
+
+		// Solution to the problem Ux=y
+		ENSIIE_PROFILE_SCOPE(back_substitution, N_ - 1);
+		for (int j = (N_ - 1); j > 0; j--)
+		{
+			v[j] = (y[j] + (scale * gamma_[j] - mass_up_[j]) * v[j + 1]) / up[j];
+		}
+	}
+
+	void Complete::implicit_euler(std::vector<double>& v, double scale, const std::vector<double>& low, const std::vector<double>& up,
+		double lower, double upper, std::vector<double>& y) const
+	{
+		// Solution to the problem Ly=b, b being the mass matrix times the old layer
+		{
+			ENSIIE_PROFILE_SCOPE(forward_sweep, N_ + 1);
+			y[0] = mass_diag_[0] * v[0] + mass_up_[0] * v[1];
+			for (int j = 1; j < N_; j++)
+			{
+				y[j] = (mass_low_[j] * v[j - 1] + mass_diag_[j] * v[j] + mass_up_[j] * v[j + 1]) - low[j] * y[j - 1];
+			}
+			y[N_] = (mass_low_[N_] * v[N_ - 1] + mass_diag_[N_] * v[N_]) - low[N_] * y[N_ - 1];
+		}
+
+		// Boundary conditions for s=0 and s=L
+		v[0] = lower;
+		v[N_] = upper;
+
+		// Solution to the problem Ux=y, the matrix being the one of a step 2 * scale
+		ENSIIE_PROFILE_SCOPE(back_substitution, N_ - 1);
+		for (int j = (N_ - 1); j > 0; j--)
+		{
+			v[j] = (y[j] + (2 * scale * gamma_[j] - mass_up_[j]) * v[j + 1]) / up[j];
+		}
+	}
+
+	int Complete::solve_threads() const
+	{
+		int threads = (threads_ == 0) ? (int)std::thread::hardware_concurrency() : (int)threads_;
+
+		// Crossover, each thread needs enough rows to cover the launches
+		threads = std::min(threads, (int)((N_ + 1) / parallel_rows));
+
+		return std::max(threads, 1);
+	}
+
+	void Complete::parallel_crank_nicolson(std::vector<double>& v, double scale, const std::vector<double>& low, const std::vector<double>& up,
+		double lower, double upper, std::vector<double>& b, std::vector<double>& y, WorkerPool& pool) const
+	{
+		int n = (int)N_;
+		int threads = pool.size();
+		double eps = std::numeric_limits<double>::epsilon();
+
+		// Block k holds the rows first(k) to first(k+1)-1
+		auto first = [n, threads](int k)
+		{
+			return (int)((long long)(n + 1) * k / threads);
+		};
+
+		// Products of the factors and true end values of the blocks, from the workspace of the calling thread
+		PricingWorkspace& workspace = PricingWorkspace::local();
+		PricingWorkspace::Scope scope(workspace);
+		std::vector<double>& gain = workspace.acquire(threads);
+		std::vector<double>& carry = workspace.acquire(threads);
+
+		// Forward substitution of each block, starting from zero
+		pool.run([&](int k)
+		{
+			double g = 1;
+			for (int j = first(k); j < first(k + 1); j++)
+			{
+				if (j == 0)
+				{
+					b[j] = v[j] * (mass_diag_[j] + scale * beta_[j]) + v[j + 1] * (mass_up_[j] + scale * gamma_[j]);
+				}
+				else if (j == n)
+				{
+					b[j] = v[j] * (mass_diag_[j] + scale * beta_[j]) + v[j - 1] * (mass_low_[j] + scale * alpha_[j]);
+				}
+				else
+				{
+					b[j] = v[j] * (mass_diag_[j] + scale * beta_[j]) + v[j + 1] * (mass_up_[j] + scale * gamma_[j]) + v[j - 1] * (mass_low_[j] + scale * alpha_[j]);
+				}
+
+				y[j] = (j == first(k)) ? b[j] : b[j] - low[j] * y[j - 1];
+				g *= -low[j];
+			}
+			gain[k] = g;
+		});
+
+		// True values at the ends of the blocks, the first block having no predecessor
+		carry[0] = y[first(1) - 1];
+		for (int k = 1; k < threads; k++)
+		{
+			carry[k] = y[first(k + 1) - 1] + gain[k] * carry[k - 1];
+		}
+
+		// Boundary conditions for s=0 and s=L
+		v[0] = lower;
+		v[n] = upper;
+
+		// Correction of each block, then back substitution starting from zero (from v[N] for the last block)
+		pool.run([&](int k)
+		{
+			int begin = first(k);
+			int end = first(k + 1);
+
+			if (k > 0)
+			{
+				double d = -low[begin] * carry[k - 1];
+				for (int j = begin; j < end; j++)
+				{
+					if (j > begin)
+					{
+						d *= -low[j];
+					}
+					y[j] += d;
+					if (std::fabs(d) <= eps * std::fabs(y[j]))
+					{
+						break;
+					}
+				}
+			}
+
+			double g = 1;
+			for (int j = std::min(end, n) - 1; j >= std::max(begin, 1); j--)
+			{
+				double next = (j == end - 1 && k < threads - 1) ? 0 : v[j + 1];
+				v[j] = (y[j] + (scale * gamma_[j] - mass_up_[j]) * next) / up[j];
+				g *= (scale * gamma_[j] - mass_up_[j]) / up[j];
+			}
+			gain[k] = g;
+		});
+
+		// True values at the starts of the blocks, from the last one
+		carry[threads - 1] = v[first(threads - 1)];
+		for (int k = threads - 2; k >= 0; k--)
+		{
+			carry[k] = v[std::max(first(k), 1)] + gain[k] * carry[k + 1];
+		}
+
+		// Correction of the back substitution of each block
+		pool.run([&](int k)
+		{
+			if (k == threads - 1)
+			{
+				return;
+			}
+
+			int begin = std::max(first(k), 1);
+			double d = carry[k + 1];
+			for (int j = first(k + 1) - 1; j >= begin; j--)
+			{
+				d *= (scale * gamma_[j] - mass_up_[j]) / up[j];
+				v[j] += d;
+				if (std::fabs(d) <= eps * std::fabs(v[j]))
+				{
+					break;
+				}
+			}
+		});
+	}
+
+	void Complete::advance(std::vector<double>& v, int from, int to, int steps, const std::vector<double>& low, const std::vector<double>& up,
+		std::vector<double>& b, std::vector<double>& y, bool implicit) const
+	{
+		double scale = (double)(from - to) / steps;
+		bool on_grid = ((from - to) % steps == 0);
+
+		// Dividends already applied at t(from), including the maturity
+		int next = (int)dividend_t_.size() - 1;
+		while (next >= 0 && dividend_t_[next] >= t_[from] - 0.5 * dt_)
+		{
+			next--;
+		}
+
+		for (int i = 1; i <= steps; i++)
+		{
+			double t = on_grid ? t_[from - i * ((from - to) / steps)] : t_[from] + (t_[to] - t_[from]) * i / steps;
+
+			if (implicit)
+			{
+				implicit_euler(v, scale, low, up, lower_boundary(t), upper_boundary(t), y);
+			}
+			else
+			{
+				crank_nicolson(v, scale, low, up, lower_boundary(t), upper_boundary(t), b, y);
+			}
+
+			// Jump conditions at the ex-dividend dates, rounded to the nearest fine time step
+			while (next >= 0 && dividend_t_[next] >= t - 0.5 * dt_)
+			{
+				dividend_jump(v, dividend_D_[next]);
+				next--;
+			}
+		}
+	}
+
+	void Complete::terminal_condition(std::vector<double>& v) const
+	{
+		ENSIIE_PROFILE_SCOPE(boundaries, N_ + 1);
+		v[0] = lower_boundary(T_);
+		v[N_] = upper_boundary(T_);
+
+		// Payoff smoothed around the strike for the compact scheme
+		for (int j = 1; j < N_; j++)
+		{
+			if (compact_ && std::fabs(l_[j] - K_) < 3 * ds_ && l_[j] >= 3 * ds_)
+			{
+				v[j] = smoothed_payoff(l_[j]);
+			}
+			else
+			{
+				v[j] = payoff(l_[j]);
+			}
+		}
+	}
+
+	void Complete::sweep(std::vector<double>& v)
+	{
+		Trace::Scope trace("sweep", "complete", -1, typeid(*this).name(), N_, M_);
+
+		// A recorded or checkpointed sweep is uniform, the setters rejecting the other sweeps
+		if (slices_ > 1)
+		{
+			parareal_sweep(v);
+			return;
+		}
+
+		// Threads of the parallel solve, started once for the whole sweep and always released
+		int threads = solve_threads();
+		std::unique_ptr<WorkerPool> pool(threads > 1 ? new WorkerPool(threads) : nullptr);
+		struct PoolGuard
+		{
+			WorkerPool*& pool;
+			~PoolGuard() { pool = nullptr; }
+		} guard{ pool_ };
+		pool_ = pool.get();
+
+		if (tolerance_ > 0)
+		{
+			adaptive_sweep(v);
+			return;
+		}
+
+		// Scratch buffers of the thread, given back at the end of the sweep
+		PricingWorkspace& workspace = PricingWorkspace::local();
+		PricingWorkspace::Scope scope(workspace);
+		std::vector<double>& b = workspace.acquire(N_ + 1);
+		std::vector<double>& y = workspace.acquire(N_ + 1);
+
+		v.resize(N_ + 1);
+
+		// Boundary condition for t=T, or layer of the last checkpoint
+		int done = 0;
+		if (!checkpoint_ || !checkpoint_->restore(*this, checkpoint_kind(), done, v))
+		{
+			terminal_condition(v);
+			maturity_jumps(v);
+			if (surface_)
+			{
+				surface_->write_layer((int)M_, v);
+			}
+		}
+
+		// Index of the next dividend met by the backward sweep, the jumps of the terminal layer or
+		// of the resumed steps being done
+		int next = (int)dividend_t_.size() - 1;
+		while (next >= 0 && dividend_t_[next] >= t_[M_ - done] - 0.5 * dt_)
+		{
+			next--;
+		}
+
+		// Iterative solution, the layer i corresponding to the time t(M-i)
+		for (int i = done + 1; i <= M_; i++)
+		{
+			double lower, upper;
+			{
+				ENSIIE_PROFILE_SCOPE(boundaries, 2);
+				lower = lower_boundary(t_[M_ - i]);
+				upper = upper_boundary(t_[M_ - i]);
+			}
+			crank_nicolson(v, 1, low_, up_, lower, upper, b, y);
+
+			// Jump conditions at the ex-dividend dates, rounded to the nearest time step
+			while (next >= 0 && dividend_t_[next] >= t_[M_ - i] - 0.5 * dt_)
+			{
+				dividend_jump(v, dividend_D_[next]);
+				next--;
+			}
+
+			if (surface_)
+			{
+				surface_->write_layer((int)M_ - i, v);
+			}
+			if (checkpoint_ && i < M_ && checkpoint_->due(i))
+			{
+				checkpoint_->save(*this, checkpoint_kind(), i, v);
+			}
+		}
+
+		if (checkpoint_)
+		{
+			checkpoint_->clear();
+		}
+		steps_ = (int)M_;
+	}
+
+	std::string Complete::checkpoint_kind() const
+	{
+		return std::string(typeid(*this).name()) + (compact_ ? " compact" : " central");
+	}
+
+	void Complete::check_sweeps(bool recorded, bool other)
+	{
+		if (recorded && other)
+		{
+			throw std::invalid_argument("A recorded or checkpointed sweep uses uniform time steps, it can not be adaptive or Parareal");
+		}
+	}
+
+	void Complete::adaptive_sweep(std::vector<double>& v)
+	{
+		PricingWorkspace& workspace = PricingWorkspace::local();
+		PricingWorkspace::Scope scope(workspace);
+		std::vector<double>& start = workspace.acquire(N_ + 1);
+		std::vector<double>& full = workspace.acquire(N_ + 1);
+		std::vector<double>& b = workspace.acquire(N_ + 1);
+		std::vector<double>& y = workspace.acquire(N_ + 1);
+
+		v.resize(N_ + 1);
+
+		// Factorizations for the steps dt_ * 2^(k-1), the step dt_ / 2 being at index 0
+		std::vector<std::vector<double>> low_cache, up_cache;
+		std::vector<double> low_full, up_full, low_half, up_half;
+
+		// Boundary condition for t=T
+		terminal_condition(v);
+
+		int next = (int)dividend_t_.size() - 1;
+		int level = 0;
+		double t = T_;
+		double eps = 1e-12 * T_;
+		steps_ = 0;
+
+		while (true)
+		{
+			// Jump conditions at the ex-dividend dates, which the steps never cross
+			while (next >= 0 && dividend_t_[next] >= t - eps)
+			{
+				dividend_jump(v, dividend_D_[next]);
+				next--;
+			}
+
+			if (t <= eps)
+			{
+				break;
+			}
+
+			// Step of the current size, shortened to stop at the next event
+			double stop = (next >= 0) ? dividend_t_[next] : 0;
+			double scale = std::ldexp(1.0, level);
+			bool shortened = (t - scale * dt_ <= stop + eps);
+
+			const std::vector<double>* lf;
+			const std::vector<double>* uf;
+			const std::vector<double>* lh;
+			const std::vector<double>* uh;
+
+			if (shortened)
+			{
+				scale = (t - stop) / dt_;
+				factorization(scale, low_full, up_full);
+				factorization(0.5 * scale, low_half, up_half);
+				lf = &low_full;
+				uf = &up_full;
+				lh = &low_half;
+				uh = &up_half;
+			}
+			else
+			{
+				while ((int)low_cache.size() < level + 2)
+				{
+					low_cache.emplace_back();
+					up_cache.emplace_back();
+					factorization(std::ldexp(1.0, (int)low_cache.size() - 2), low_cache.back(), up_cache.back());
+				}
+				lf = &low_cache[level + 1];
+				uf = &up_cache[level + 1];
+				lh = &low_cache[level];
+				uh = &up_cache[level];
+			}
+
+			double dt = scale * dt_;
+			double t_new = shortened ? stop : t - dt;
+
+			// One full step and two half steps, the layer being kept in case of rejection
+			start = v;
+			full = v;
+			crank_nicolson(full, scale, *lf, *uf, lower_boundary(t_new), upper_boundary(t_new), b, y);
+			crank_nicolson(v, 0.5 * scale, *lh, *uh, lower_boundary(t - 0.5 * dt), upper_boundary(t - 0.5 * dt), b, y);
+			crank_nicolson(v, 0.5 * scale, *lh, *uh, lower_boundary(t_new), upper_boundary(t_new), b, y);
+
+			double error = 0;
+			for (int j = 0; j <= N_; j++)
+			{
+				error = std::max(error, std::fabs(v[j] - full[j]));
+			}
+
+			// Rejection, the layer is restored and the step halved, down to dt_, a step of level 0
+			// shortened to an event being dt_ up to rounding at most
+			if (error > tolerance_ && level > 0 && scale > 1)
+			{
+				v = start;
+				level = std::max(0, level - 1);
+				while (level > 0 && std::ldexp(1.0, level) * dt_ >= t - stop - eps)
+				{
+					level--;
+				}
+				continue;
+			}
+
+			t = t_new;
+			steps_++;
+
+			if (error < tolerance_ / 8 && scale * dt_ * 2 <= T_)
+			{
+				level++;
+			}
+		}
+	}
+
+	void Complete::parareal_sweep(std::vector<double>& v)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		int slices = std::min(slices_, (int)M_);
+
+		// Slice n goes from the index bound[n] to bound[n+1], backward from T
+		std::vector<int> bound(slices + 1);
+		for (int n = 0; n <= slices; n++)
+		{
+			bound[n] = (int)M_ - (int)std::lround(M_ * n / slices);
+		}
+
+		// Coarse implicit Euler factorizations, shared by the slices of the same length
+		std::map<int, std::pair<std::vector<double>, std::vector<double>>> coarse;
+		for (int n = 0; n < slices; n++)
+		{
+			int length = bound[n] - bound[n + 1];
+			if (coarse.count(length) == 0)
+			{
+				auto& factors = coarse[length];
+				factorization(2.0 * length / coarse_steps_, factors.first, factors.second);
+			}
+		}
+
+		auto coarse_step = [&](std::vector<double>& v, int n, std::vector<double>& b, std::vector<double>& y)
+		{
+			const auto& factors = coarse.at(bound[n] - bound[n + 1]);
+			advance(v, bound[n], bound[n + 1], coarse_steps_, factors.first, factors.second, b, y, true);
+		};
+
+		// Layers at the slice dates, fine results and coarse results of the previous iteration
+		std::vector<std::vector<double>> u(slices + 1, std::vector<double>(N_ + 1));
+		std::vector<std::vector<double>> fine(slices, std::vector<double>(N_ + 1));
+		std::vector<std::vector<double>> coarse_old(slices, std::vector<double>(N_ + 1));
+		std::vector<double> b(N_ + 1);
+		std::vector<double> y(N_ + 1);
+
+		// The threads go over the slices, each solve stays sequential
+		unsigned int n_threads = (threads_ == 0) ? std::max(1u, std::thread::hardware_concurrency()) : threads_;
+
+		// The number of threads of the solve is restored on exit, even by an exception
+		struct ThreadsGuard
+		{
+			unsigned int& threads;
+			unsigned int saved;
+			~ThreadsGuard() { threads = saved; }
+		} guard{ threads_, threads_ };
+		threads_ = 1;
+
+		// Prediction by the coarse propagator, timed to extrapolate the cost of a serial sweep
+		terminal_condition(u[0]);
+		maturity_jumps(u[0]);
+		auto predict = std::chrono::steady_clock::now();
+		for (int n = 0; n < slices; n++)
+		{
+			coarse_old[n] = u[n];
+			coarse_step(coarse_old[n], n, b, y);
+			u[n + 1] = coarse_old[n];
+		}
+		double step_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - predict).count() / (slices * coarse_steps_);
+
+		iterations_ = 0;
+		for (int k = 1; k <= slices; k++)
+		{
+			// Fine solves of the slices not yet exact, concurrently
+			std::vector<std::thread> threads;
+			for (unsigned int p = 0; p < n_threads; p++)
+			{
+				threads.emplace_back([&, p]()
+				{
+					std::vector<double> b_p(N_ + 1);
+					std::vector<double> y_p(N_ + 1);
+					for (int n = k - 1 + (int)p; n < slices; n += (int)n_threads)
+					{
+						fine[n] = u[n];
+						advance(fine[n], bound[n], bound[n + 1], bound[n] - bound[n + 1], low_, up_, b_p, y_p);
+					}
+				});
+			}
+			for (auto& th : threads)
+			{
+				th.join();
+			}
+
+			// Serial correction, U(n+1) = G(U(n)) + F(U_old(n)) - G(U_old(n))
+			double change = 0;
+			std::vector<double> g(N_ + 1);
+			for (int n = k - 1; n < slices; n++)
+			{
+				g = u[n];
+				coarse_step(g, n, b, y);
+				for (int j = 0; j <= N_; j++)
+				{
+					double value = g[j] + fine[n][j] - coarse_old[n][j];
+					change = std::max(change, std::fabs(value - u[n + 1][j]));
+					u[n + 1][j] = value;
+				}
+				coarse_old[n] = g;
+			}
+
+			iterations_ = k;
+			if (change <= parareal_tol_)
+			{
+				break;
+			}
+		}
+
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		estimated_speedup_ = (elapsed > 0) ? M_ * step_time / elapsed : 1;
+		steps_ = (int)M_;
+
+		v = u[slices];
+	}
+
+	double Complete::payoff(double s) const
+	{
+		(void)s;
+		throw std::logic_error("The terminal condition is not defined for this engine");
+	}
+
+	double Complete::smoothed_payoff(double s) const
+	{
+		const double x_gauss[3] = { -0.7745966692414834, 0, 0.7745966692414834 };
+		const double w_gauss[3] = { 5.0 / 9, 8.0 / 9, 5.0 / 9 };
+
+		// Cubic B-spline centered in 0
+		auto spline = [](double x)
+		{
+			x = std::fabs(x);
+			if (x < 1)
+			{
+				return (4 - 6 * x * x + 3 * x * x * x) / 6;
+			}
+			else if (x < 2)
+			{
+				return (2 - x) * (2 - x) * (2 - x) / 6;
+			}
+			return 0.0;
+		};
+
+		// Integration intervals between the knots -3, ..., 3 and the strike, on the stack
+		double knots[8];
+		int count = 0;
+		for (int k = -3; k <= 3; k++)
+		{
+			knots[count++] = k;
+		}
+
+		double kink = (s - K_) / ds_;
+		if (std::fabs(kink) < 3)
+		{
+			knots[count++] = kink;
+			std::sort(knots, knots + count);
+		}
+
+		double smoothed = 0;
+		for (int k = 0; k + 1 < count; k++)
+		{
+			double half = 0.5 * (knots[k + 1] - knots[k]);
+			double mid = 0.5 * (knots[k + 1] + knots[k]);
+
+			for (int g = 0; g < 3; g++)
+			{
+				double x = mid + half * x_gauss[g];
+				double kernel = 4.0 / 3 * spline(x) - (spline(x - 1) + spline(x + 1)) / 6;
+				smoothed += half * w_gauss[g] * kernel * payoff(s - x * ds_);
+			}
+		}
+
+		return smoothed;
+	}
+
+	double Complete::lower_boundary(double t) const
+	{
+		(void)t;
+		throw std::logic_error("The boundary condition for s=0 is not defined for this engine");
+	}
+
+	double Complete::upper_boundary(double t) const
+	{
+		(void)t;
+		throw std::logic_error("The boundary condition for s=L is not defined for this engine");
+	}
+
+	void Complete::maturity_jumps(std::vector<double>& v) const
+	{
+		for (int k = (int)dividend_t_.size() - 1; k >= 0 && dividend_t_[k] >= T_ - 0.5 * dt_; k--)
+		{
+			dividend_jump(v, dividend_D_[k]);
+		}
+	}
+
+	double Complete::dividend_pv(double t) const
+	{
+		double pv = 0;
+
+		for (int k = 0; k < (int)dividend_t_.size(); k++)
+		{
+			if (dividend_t_[k] > t)
+			{
+				pv += dividend_D_[k] * std::exp(-r_ * (dividend_t_[k] - t));
+			}
+		}
+
+		return pv;
+	}
+
+	void Complete::dividend_jump(std::vector<double>& v, double D) const
+	{
+		// V(s_j - D) only depends on nodes below j, so the remap can go downwards in-place
+		for (int j = (int)N_; j > 0; j--)
+		{
+			double x = (l_[j] - D) / ds_;
+
+			if (x <= 0)
+			{
+				v[j] = v[0];
+			}
+			else
+			{
+				int k = std::min((int)x, (int)N_ - 1);
+				double w = x - k;
+				v[j] = (1 - w) * v[k] + w * v[k + 1];
+			}
+		}
+	}
+
+	void Complete::add_dividend(double t, double D)
+	{
+		if (t < 0 || t > T_ || D < 0)
+		{
+			throw std::invalid_argument("Dividend date must be in [0, T] and amount non-negative");
+		}
+
+		// Insertion keeping the schedule sorted by ex-date
+		int k = (int)dividend_t_.size();
+		while (k > 0 && dividend_t_[k - 1] > t)
+		{
+			k--;
+		}
+
+		dividend_t_.insert(dividend_t_.begin() + k, t);
+		dividend_D_.insert(dividend_D_.begin() + k, D);
+	}
+
+	Complete::Complete(double T, double r, double sigma, double K, double L, double M, double N) : Data(T, r, sigma, K, L, M, N), compact_(false), tolerance_(0), steps_(0), threads_(0), pool_(nullptr), slices_(1), coarse_steps_(1), parareal_tol_(0), iterations_(0), estimated_speedup_(1), surface_(nullptr), checkpoint_(nullptr)
+	{
+		coefficients_computation();
+		lu_factorization();
+	}
+
+	Complete::Complete(const Data& d) : Data(d), compact_(false), tolerance_(0), steps_(0), threads_(0), pool_(nullptr), slices_(1), coarse_steps_(1), parareal_tol_(0), iterations_(0), estimated_speedup_(1), surface_(nullptr), checkpoint_(nullptr)
+	{
+		coefficients_computation();
+		lu_factorization();
+	}
+
+	const std::vector<double>& Complete::get_alpha() const
+	{
+		return alpha_;
+	}
+
+	const std::vector<double>& Complete::get_beta() const
+	{
+		return beta_;
+	}
+
+	const std::vector<double>& Complete::get_gamma() const
+	{
+		return gamma_;
+	}
+
+	void Complete::set_compact(bool compact)
+	{
+		compact_ = compact;
+		coefficients_computation();
+		lu_factorization();
+	}
+
+	bool Complete::get_compact() const
+	{
+		return compact_;
+	}
+
+	const std::vector<double>& Complete::get_low() const
+	{
+		return low_;
+	}
+
+	const std::vector<double>& Complete::get_up() const
+	{
+		return up_;
+	}
+
+	const std::vector<double>& Complete::get_dividend_t() const
+	{
+		return dividend_t_;
+	}
+
+	const std::vector<double>& Complete::get_dividend_D() const
+	{
+		return dividend_D_;
+	}
+
+	void Complete::set_tolerance(double tol)
+	{
+		if (tol < 0)
+		{
+			throw std::invalid_argument("The tolerance must be non-negative");
+		}
+		check_sweeps(surface_ || checkpoint_, tol > 0);
+
+		tolerance_ = tol;
+	}
+
+	double Complete::get_tolerance() const
+	{
+		return tolerance_;
+	}
+
+	int Complete::get_steps() const
+	{
+		return steps_;
+	}
+
+	void Complete::set_threads(unsigned int threads)
+	{
+		threads_ = threads;
+	}
+
+	unsigned int Complete::get_threads() const
+	{
+		return threads_;
+	}
+
+	void Complete::set_parareal(int slices, double tol, int coarse_steps)
+	{
+		if (slices <= 0 || coarse_steps <= 0 || tol < 0)
+		{
+			throw std::invalid_argument("The numbers of slices and of coarse steps must be positive and the tolerance non-negative");
+		}
+		check_sweeps(surface_ || checkpoint_, slices > 1);
+
+		slices_ = slices;
+		parareal_tol_ = tol;
+		coarse_steps_ = coarse_steps;
+		iterations_ = 0;
+		estimated_speedup_ = 1;
+	}
+
+	int Complete::get_iterations() const
+	{
+		return iterations_;
+	}
+
+	double Complete::get_estimated_speedup() const
+	{
+		return estimated_speedup_;
+	}
+
+	void Complete::set_surface(SurfaceWriter* surface)
+	{
+		check_sweeps(surface != nullptr, tolerance_ > 0 || slices_ > 1);
+		surface_ = surface;
+	}
+
+	void Complete::set_checkpoint(Checkpoint* checkpoint)
+	{
+		check_sweeps(checkpoint != nullptr, tolerance_ > 0 || slices_ > 1);
+		checkpoint_ = checkpoint;
+	}
 }
\ No newline at end of file
@@ -1,133 +1,574 @@
-#pragma once
-#include "data.h"
-#include <algorithm>
-#include <cmath>
-
-namespace ensiie
-{
-	/**
-	 * @class Complete
-	 * @brief A base abstract class for solving financial models using Crank-Nicolson methods.
-	 *
-	 * The `Complete` class extends the `Data` class and serves as an abstract base for solving
-	 * partial differential equations (PDEs) related to call and put options pricing.
-	 * It provides the structure and common functionality for subclasses, involved in deterining prices 
-	 * for call and put optiont, computing coefficients used in Crank-Nicolson schemes, 
-	 * performing LU factorization of the coefficients' matrix, and providing access to the computed values.
-	 *
-	 * @details
-	 * This abstract class includes methods for:
-	 * - Calculation of the coefficients (`alpha`, `beta`, `gamma`) for Crank-Nicolson methods.
-	 * - LU factorization for efficient solving of tridiagonal systems.
-	 *
-	 * Subclasses derived from `Complete` implement the specific algorithm of the PDE solver, including
-	 * boundary conditions, to get the european call and put option pricing.
-	 *
-	 * The class can be initialized via direct parameter input or using an existing `Data` object.
-	 *
-	 * @note This class cannot be instantiated directly due to its abstract nature.
-	 */
-	class Complete : public Data
-	{
-	protected:
-		std::vector<double> alpha_;
-		std::vector<double> beta_;
-		std::vector<double> gamma_;
-		std::vector<double> low_;
-		std::vector<double> up_;
-
-		/**
-		 * @brief Computes the coefficients (alpha, beta, gamma) for the Crank-Nicolson scheme.
-		 *
-		 * These coefficients are used in the matrix representation of the problem.
-		 * The computation is based on the model parameters and discretization values.
-		 */
-		void coefficients_computation();
-
-		/**
-		 * @brief Performs LU factorization of the system's matrix for Crank-Nicholson scheme.
-		 *
-		 * This method calculates the lower (low) and upper (up) matrices, which are
-		 * used to solve the system of equations iteratively.
-		 */
-		void lu_factorization();
-
-	public:
-
-		/**
-		 * @brief Constructs a Complete object with the given parameters.
-		 *
-		 * This constructor initializes the base `Data` class and computes
-		 * the coefficients and LU factorization.
-		 *
-		 * @param T Total time to maturity (in years).
-		 * @param r Risk-free interest rate.
-		 * @param sigma Volatility of the underlying asset.
-		 * @param K Strike price.
-		 * @param L Maximum asset price for discretization.
-		 * @param M Number of time steps.
-		 * @param N Number of space steps.
-		 */
-		Complete(double T, double r, double sigma, double K, double L, double M, double N);
-		
-		/**
-		 * @brief Constructs a Complete object using an existing Data object.
-		 *
-		 * This constructor takes the parameters from an existing `Data` object
-		 * and computes the coefficients and LU factorization.
-		 * 
-		 * Note: The `Data` object `d` is not copied; its values are used to initialize 
-		 * the base class `Data` members. Therefore, the member of the class 'Data'
-		 * exists only once in memory, shared between the `Data` and `Complete` objects.
-		 * 
-		 * @param d A `Data` object to initialize the base class.
-		 */
-		Complete(const Data& d);
-
-		/**
-		 * @brief Pure virtual function to compute the price of the option.
-		 *
-		 * This is a pure virtual function that is implemented by its derived class.
-		 * 
-		 * It defines the computation of Call and Put options price.
-		 * The specific implementation will based on different boundary conditions.
-		 *
-		 * @note Since this is a pure virtual function, `Complete` cannot be instantiated directly.
-		 */
-		virtual void pricing() = 0;
-
-		/**
-		 * @brief Gets the alpha coefficients for the Crank_Nicolson scheme.
-		 * @return A vector of alpha coefficients.
-		 */
-		std::vector<double> get_alpha() const;
-
-		/**
-		 * @brief Gets the beta coefficients for the Crank_Nicolson scheme.
-		 * @return A vector of beta coefficients.
-		 */
-		std::vector<double> get_beta() const;
-
-		/**
-		 * @brief Gets the gamma coefficients for the Crank_Nicolson scheme.
-		 * @return A vector of gamma coefficients.
-		 */
-		std::vector<double> get_gamma() const;
-
-		/**
-		 * @brief Gets the lower matrix values of coefficients' matrix
-		 * from the LU factorization.
-		 * 
-		 * @return A vector of lower matrix values (low).
-		 */
-		std::vector<double> get_low() const;
-
-		/**
-		 * @brief Gets the upper matrix values of coefficients' matrix
-		 * from the LU factorization.
-		 * 
-		 * @return A vector of upper matrix values (up).
-		 */
-		std::vector<double> get_up() const;
-	};
+#pragma once
+#include "data.h"
+#include "workspace.h"
+#include "workerpool.h"
+#include "surface.h"
+#include "checkpoint.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <limits>
+#include <thread>
+#include <typeinfo>
+
+namespace ensiie
+{
+	/**
+	 * @class Complete
+	 * @brief A base abstract class for solving financial models using Crank-Nicolson methods.
+	 *
+	 * The `Complete` class extends the `Data` class and serves as an abstract base for solving
+	 * partial differential equations (PDEs) related to call and put options pricing.
+	 * It provides the structure and common functionality for subclasses, involved in deterining prices 
+	 * for call and put optiont, computing coefficients used in Crank-Nicolson schemes, 
+	 * performing LU factorization of the coefficients' matrix, and providing access to the computed values.
+	 *
+	 * @details
+	 * This abstract class includes methods for:
+	 * - Calculation of the coefficients (`alpha`, `beta`, `gamma`) for Crank-Nicolson methods.
+	 * - LU factorization for efficient solving of tridiagonal systems.
+	 *
+	 * Subclasses derived from `Complete` implement the specific algorithm of the PDE solver, including
+	 * boundary conditions, to get the european call and put option pricing.
+	 *
+	 * The class can be initialized via direct parameter input or using an existing `Data` object.
+	 *
+	 * @note This class cannot be instantiated directly due to its abstract nature.
+	 */
+	class Complete : public Data
+	{
+	protected:
+		static const int parallel_rows = 65536; /**< Minimum number of rows per thread of the parallel tridiagonal solve.*/
+
+		std::vector<double> alpha_;
+		std::vector<double> beta_;
+		std::vector<double> gamma_;
+		std::vector<double> mass_low_; /**< Lower diagonal of the mass matrix, 0 for the central scheme.*/
+		std::vector<double> mass_diag_; /**< Diagonal of the mass matrix, 1 for the central scheme.*/
+		std::vector<double> mass_up_; /**< Upper diagonal of the mass matrix, 0 for the central scheme.*/
+		bool compact_; /**< Use of the fourth-order compact scheme in space.*/
+		std::vector<double> low_;
+		std::vector<double> up_;
+		std::vector<double> dividend_t_; /**< Ex-dividend dates, sorted in increasing order.*/
+		std::vector<double> dividend_D_; /**< Cash dividend paid at the corresponding ex-date.*/
+		double tolerance_; /**< Local error tolerance of the adaptive time stepping, 0 for uniform steps.*/
+		int steps_; /**< Number of time steps done by the last sweep.*/
+		unsigned int threads_; /**< Number of threads of the tridiagonal solve, 0 for the number of hardware threads.*/
+		WorkerPool* pool_; /**< Threads of the parallel tridiagonal solve during a sweep, null for the sequential solve.*/
+		int slices_; /**< Number of time slices of the Parareal sweep, 1 for the serial sweep.*/
+		int coarse_steps_; /**< Number of coarse time steps per slice of the Parareal sweep.*/
+		double parareal_tol_; /**< Tolerance on the change of the prices between two Parareal iterations.*/
+		int iterations_; /**< Number of iterations done by the last Parareal sweep.*/
+		double estimated_speedup_; /**< Estimated speedup of the last Parareal sweep over the serial one.*/
+		SurfaceWriter* surface_; /**< Writer of the layers of the sweep, null if not recorded.*/
+		Checkpoint* checkpoint_; /**< Checkpoint of the sweep, null if not checkpointed.*/
+
+		/**
+		 * @brief Computes the coefficients (alpha, beta, gamma) for the Crank-Nicolson scheme.
+		 *
+		 * These coefficients are used in the matrix representation of the problem.
+		 * The computation is based on the model parameters and discretization values.
+		 *
+		 * With the fourth-order compact scheme, the third and fourth derivatives in the
+		 * truncation error of the central differences are eliminated by differentiating the
+		 * PDE itself. For the Black-Scholes operator this only adds the constant
+		 * kappa = (r + sigma^2) / 12 - (2 sigma^2 - r)(sigma^2 + r) / (6 sigma^2) to the
+		 * diffusion coefficient sigma^2 j^2 / 2, and brings a tridiagonal mass matrix
+		 * (1/12 + m_j, 10/12, 1/12 - m_j) with m_j = (2 sigma^2 - r) / (12 sigma^2 j)
+		 * on the time derivative. The system of each step stays tridiagonal.
+		 */
+		void coefficients_computation();
+
+		/**
+		 * @brief Performs LU factorization of the system's matrix for Crank-Nicholson scheme.
+		 *
+		 * This method calculates the lower (low) and upper (up) matrices, which are
+		 * used to solve the system of equations iteratively.
+		 */
+		void lu_factorization();
+
+		/**
+		 * @brief Performs LU factorization of the system's matrix for a time step scale * dt.
+		 *
+		 * The coefficients alpha, beta and gamma being proportional to the time step, the
+		 * matrix of a step scale * dt is obtained by scaling them.
+		 *
+		 * @param scale Ratio between the time step and `dt_`.
+		 * @param low Lower matrix values, overwritten.
+		 * @param up Upper matrix values, overwritten.
+		 */
+		void factorization(double scale, std::vector<double>& low, std::vector<double>& up) const;
+
+		/**
+		 * @brief Performs one backward Crank-Nicolson step on a time layer.
+		 *
+		 * The layer is overwritten in-place: the right-hand side and the forward substitution
+		 * are computed in a single pass reading the old layer, then the back substitution
+		 * writes the new one.
+		 *
+		 * @param v Time layer of prices, from the later time to the earlier one.
+		 * @param scale Ratio between the time step and `dt_`.
+		 * @param low Lower matrix values for this time step.
+		 * @param up Upper matrix values for this time step.
+		 * @param lower Boundary condition for s=0 at the earlier time.
+		 * @param upper Boundary condition for s=L at the earlier time.
+		 * @param b Scratch vector for the right-hand side.
+		 * @param y Scratch vector for the forward substitution.
+		 */
+		void crank_nicolson(std::vector<double>& v, double scale, const std::vector<double>& low, const std::vector<double>& up,
+			double lower, double upper, std::vector<double>& b, std::vector<double>& y) const;
+
+		/**
+		 * @brief Performs one backward implicit Euler step on a time layer.
+		 *
+		 * The step being scale * dt, the matrix is the one of a Crank-Nicolson step of
+		 * 2 * scale * dt and the right-hand side is the mass matrix times the old layer. The
+		 * scheme is only first order but damps the stiff modes, which makes it the coarse
+		 * propagator of the Parareal sweep.
+		 *
+		 * @param v Time layer of prices, from the later time to the earlier one.
+		 * @param scale Ratio between the time step and `dt_`.
+		 * @param low Lower matrix values for 2 * scale.
+		 * @param up Upper matrix values for 2 * scale.
+		 * @param lower Boundary condition for s=0 at the earlier time.
+		 * @param upper Boundary condition for s=L at the earlier time.
+		 * @param y Scratch vector for the forward substitution.
+		 */
+		void implicit_euler(std::vector<double>& v, double scale, const std::vector<double>& low, const std::vector<double>& up,
+			double lower, double upper, std::vector<double>& y) const;
+
+		/**
+		 * @brief Gets the number of threads used to solve the system of a time step.
+		 *
+		 * The parallel solve costs three barriers per time step and about twice the arithmetic
+		 * of the sequential one, so it is only used when each thread gets at least
+		 * `parallel_rows` rows. The engines using the threads otherwise override it.
+		 *
+		 * @return Number of threads, 1 for the sequential solve.
+		 */
+		virtual int solve_threads() const;
+
+		/**
+		 * @brief Performs one backward Crank-Nicolson step with a partitioned (SPIKE) solve.
+		 *
+		 * The rows are split in contiguous blocks, one per thread. Each block first solves
+		 * the forward substitution as if the value before it were zero. The true values at the
+		 * ends of the blocks are then chained sequentially, and each block adds the correction
+		 * of its first value, propagated by the products of the factors. The matrix being
+		 * diagonally dominant, this correction decays geometrically and the propagation stops
+		 * as soon as it is negligible. The back substitution is split in the same way.
+		 *
+		 * The three phases run on the pool started by the sweep, and the ends of the blocks are
+		 * kept in buffers of the workspace, so a step neither launches threads nor allocates.
+		 *
+		 * The result is the one of `crank_nicolson()`, up to rounding.
+		 *
+		 * @param v Time layer of prices, from the later time to the earlier one.
+		 * @param scale Ratio between the time step and `dt_`.
+		 * @param low Lower matrix values for this time step.
+		 * @param up Upper matrix values for this time step.
+		 * @param lower Boundary condition for s=0 at the earlier time.
+		 * @param upper Boundary condition for s=L at the earlier time.
+		 * @param b Scratch vector for the right-hand side.
+		 * @param y Scratch vector for the forward substitution.
+		 * @param pool Threads of the solve, one block per thread.
+		 */
+		void parallel_crank_nicolson(std::vector<double>& v, double scale, const std::vector<double>& low, const std::vector<double>& up,
+			double lower, double upper, std::vector<double>& b, std::vector<double>& y, WorkerPool& pool) const;
+
+		/**
+		 * @brief Propagates a time layer backward between two dates of the time grid.
+		 *
+		 * The interval from t(from) to t(to) is covered by `steps` equal Crank-Nicolson or
+		 * implicit Euler steps, and the dividend jumps are applied after the step to the date
+		 * nearest to each ex-date, as in `sweep()`. With Crank-Nicolson and `steps` equal to
+		 * `from - to`, the steps are the ones of `sweep()`.
+		 *
+		 * @param v Time layer at t(from), overwritten with the layer at t(to).
+		 * @param from Index of the later date.
+		 * @param to Index of the earlier date.
+		 * @param steps Number of time steps.
+		 * @param low Lower matrix values for the steps, as expected by the scheme.
+		 * @param up Upper matrix values for the steps, as expected by the scheme.
+		 * @param b Scratch vector for the right-hand side.
+		 * @param y Scratch vector for the forward substitution.
+		 * @param implicit True for implicit Euler steps, false for Crank-Nicolson ones.
+		 */
+		void advance(std::vector<double>& v, int from, int to, int steps, const std::vector<double>& low, const std::vector<double>& up,
+			std::vector<double>& b, std::vector<double>& y, bool implicit = false) const;
+
+		/**
+		 * @brief Fills a time layer with the condition at t=T.
+		 *
+		 * The boundary nodes take the boundary conditions and the interior ones the payoff,
+		 * smoothed around the strike when the compact scheme is used.
+		 *
+		 * @param v Time layer, overwritten.
+		 */
+		void terminal_condition(std::vector<double>& v) const;
+
+		/**
+		 * @brief Applies to the terminal condition the jumps of the ex-dividend dates rounded to T.
+		 *
+		 * The uniform sweeps round each ex-dividend date to the nearest time step, so the dates
+		 * from T - dt/2 to T are at maturity and their jumps are applied to the payoff, as the
+		 * adaptive sweep does for a date at T.
+		 *
+		 * @param v Terminal condition, overwritten.
+		 */
+		void maturity_jumps(std::vector<double>& v) const;
+
+		/**
+		 * @brief Solves the PDE backward from T to 0 and returns the layer at time 0.
+		 *
+		 * The terminal condition and the boundary conditions are given by `payoff()`,
+		 * `lower_boundary()` and `upper_boundary()`. Uniform steps of `dt_` are used,
+		 * unless the adaptive or the Parareal sweep has been enabled. When a
+		 * surface writer is set, each layer is written once computed. With a checkpoint,
+		 * the sweep resumes from the saved layer.
+		 *
+		 * The scratch buffers come from the workspace of the calling thread and the result is
+		 * written in place, so repeated sweeps on the same grid do not allocate memory. When
+		 * `solve_threads()` is above 1, the threads of the parallel solve are started once for
+		 * the uniform or adaptive sweep and joined at its end.
+		 *
+		 * @param v Vector overwritten with the prices at time 0 for each level of underlying price s.
+		 */
+		void sweep(std::vector<double>& v);
+
+		/**
+		 * @brief Describes the engine and the scheme, so that a checkpoint is resumed by the same solve.
+		 * @return The dynamic type of the engine and the discretization in space.
+		 */
+		std::string checkpoint_kind() const;
+
+		/**
+		 * @brief Checks that a recorded or checkpointed sweep is not combined with another sweep.
+		 *
+		 * The layers of the adaptive and the Parareal sweeps are not those of the
+		 * uniform time grid, so they can not be written in a surface file or checkpointed.
+		 *
+		 * @param recorded True if a surface writer or a checkpoint is set.
+		 * @param other True if the adaptive or the Parareal sweep is enabled.
+		 * @throws std::invalid_argument If both are true.
+		 */
+		static void check_sweeps(bool recorded, bool other);
+
+		/**
+		 * @brief Solves the PDE backward from T to 0 with adaptive time steps.
+		 *
+		 * The time steps are `dt_` times a power of two, starting with `dt_` near the
+		 * payoff discontinuity. The local error is estimated by step doubling, comparing one
+		 * step with two half steps: the step is rejected and halved when the error exceeds
+		 * the tolerance, and doubled when it is below an eighth of it, the local error of
+		 * Crank-Nicolson being of third order. The factorizations are kept for each step
+		 * size, so the system is factorized again only when the step changes to a new size.
+		 *
+		 * @param v Vector overwritten with the prices at time 0 for each level of underlying price s.
+		 */
+		void adaptive_sweep(std::vector<double>& v);
+
+		/**
+		 * @brief Solves the PDE backward from T to 0 with the Parareal algorithm.
+		 *
+		 * The time grid is split in slices. A coarse propagator G, made of `coarse_steps_`
+		 * implicit Euler steps per slice, predicts the layers at the slice dates serially.
+		 * Crank-Nicolson is not used there, its large steps leaving the stiff modes undamped,
+		 * which makes the iterations converge no faster than one slice at a time.
+		 * At each iteration, the fine propagator F, made of the steps `dt_` of `sweep()`, is
+		 * applied to every slice concurrently from the current layers, and the layers are
+		 * corrected serially with U(n+1) = G(U(n)) + F(U_old(n)) - G(U_old(n)). After k
+		 * iterations the first k slices are exact, so the fine solves start from slice k and
+		 * the result is the one of `sweep()` after at most one iteration per slice. The
+		 * iterations stop when the layers change by less than the tolerance.
+		 *
+		 * The speedup is only an estimate: no serial sweep is run, its time is extrapolated
+		 * to M steps from the duration of the coarse steps of the first prediction, an implicit
+		 * Euler step costing about as much as a Crank-Nicolson one.
+		 *
+		 * @param v Vector overwritten with the prices at time 0 for each level of underlying price s.
+		 */
+		void parareal_sweep(std::vector<double>& v);
+
+		/**
+		 * @brief Computes the payoff of the option at maturity.
+		 *
+		 * @param s Underlying asset price.
+		 * @return The payoff of the option.
+		 * @throws std::logic_error If the engine does not define a terminal condition.
+		 */
+		virtual double payoff(double s) const;
+
+		/**
+		 * @brief Computes the payoff smoothed by the fourth-order kernel of Kreiss.
+		 *
+		 * The kink of the payoff at the strike would bring the compact scheme back to second
+		 * order. The payoff is convolved with the kernel of Fourier transform
+		 * sinc^4(w/2) (1 + 2/3 sin^2(w/2)), which is
+		 * 4/3 B(x) - 1/6 (B(x - 1) + B(x + 1)) with B the cubic B-spline, over [-3 ds, 3 ds].
+		 * The integral is exact, by Gauss-Legendre quadrature between the knots and the strike.
+		 *
+		 * @param s Underlying asset price.
+		 * @return The smoothed payoff.
+		 */
+		double smoothed_payoff(double s) const;
+
+		/**
+		 * @brief Computes the boundary condition for s=0.
+		 *
+		 * @param t Time.
+		 * @return The price of the option for s=0 at time t.
+		 * @throws std::logic_error If the engine does not define a boundary condition.
+		 */
+		virtual double lower_boundary(double t) const;
+
+		/**
+		 * @brief Computes the boundary condition for s=L.
+		 *
+		 * @param t Time.
+		 * @return The price of the option for s=L at time t.
+		 * @throws std::logic_error If the engine does not define a boundary condition.
+		 */
+		virtual double upper_boundary(double t) const;
+
+		/**
+		 * @brief Computes the present value at time t of the dividends still to be paid.
+		 *
+		 * Only the dividends with ex-date strictly greater than t are taken into account.
+		 * It is used to correct the boundary condition on the stock side of the domain.
+		 *
+		 * @param t Time at which the present value is computed.
+		 * @return Present value of the remaining dividends.
+		 */
+		double dividend_pv(double t) const;
+
+		/**
+		 * @brief Applies the jump condition of a dividend to a time layer.
+		 *
+		 * When the backward sweep crosses an ex-date, the jump condition
+		 * V(t-, s) = V(t+, s - D) is enforced by linear interpolation on the `l_` grid.
+		 * The remap is done in-place on the nodes 1 to N, going from the top of the grid
+		 * down, so no other layer is allocated. The node N is remapped as well, since the
+		 * boundary condition of the ex-date is the one after the dividend and the layer
+		 * enters the explicit part of the next step.
+		 *
+		 * @param v Time layer of prices at the ex-date.
+		 * @param D Cash amount of the dividend.
+		 */
+		void dividend_jump(std::vector<double>& v, double D) const;
+
+	public:
+
+		/**
+		 * @brief Constructs a Complete object with the given parameters.
+		 *
+		 * This constructor initializes the base `Data` class and computes
+		 * the coefficients and LU factorization.
+		 *
+		 * @param T Total time to maturity (in years).
+		 * @param r Risk-free interest rate.
+		 * @param sigma Volatility of the underlying asset.
+		 * @param K Strike price.
+		 * @param L Maximum asset price for discretization.
+		 * @param M Number of time steps.
+		 * @param N Number of space steps.
+		 */
+		Complete(double T, double r, double sigma, double K, double L, double M, double N);
+		
+		/**
+		 * @brief Constructs a Complete object using an existing Data object.
+		 *
+		 * This constructor takes the parameters from an existing `Data` object
+		 * and computes the coefficients and LU factorization.
+		 * 
+		 * Note: The `Data` object `d` is not copied; its values are used to initialize 
+		 * the base class `Data` members. Therefore, the member of the class 'Data'
+		 * exists only once in memory, shared between the `Data` and `Complete` objects.
+		 * 
+		 * @param d A `Data` object to initialize the base class.
+		 */
+		Complete(const Data& d);
+
+		/**
+		 * @brief Pure virtual function to compute the price of the option.
+		 *
+		 * This is a pure virtual function that is implemented by its derived class.
+		 * 
+		 * It defines the computation of Call and Put options price.
+		 * The specific implementation will based on different boundary conditions.
+		 *
+		 * @note Since this is a pure virtual function, `Complete` cannot be instantiated directly.
+		 */
+		virtual void pricing() = 0;
+
+		/**
+		 * @brief Schedules a cash dividend paid at a given ex-date.
+		 *
+		 * The dividend is applied as a jump condition V(t-, s) = V(t+, s - D) when the
+		 * backward sweep of `pricing()` crosses the ex-date. The ex-date is rounded
+		 * to the nearest time step of the grid.
+		 *
+		 * @param t Ex-dividend date (in years, between 0 and T).
+		 * @param D Cash amount of the dividend.
+		 *
+		 * @throws std::invalid_argument If `t` is outside [0, T] or `D` is negative.
+		 */
+		virtual void add_dividend(double t, double D);
+
+		/**
+		 * @brief Gets the scheduled ex-dividend dates.
+		 * @return A vector of ex-dividend dates.
+		 */
+		const std::vector<double>& get_dividend_t() const;
+
+		/**
+		 * @brief Gets the scheduled cash dividends.
+		 * @return A vector of cash dividends, in the order of the ex-dates.
+		 */
+		const std::vector<double>& get_dividend_D() const;
+
+		/**
+		 * @brief Sets the local error tolerance of the adaptive time stepping.
+		 *
+		 * @param tol Tolerance on the prices for each time step, 0 to use uniform steps of `dt_`.
+		 * @throws std::invalid_argument If `tol` is negative, or positive with a surface writer or a checkpoint set.
+		 */
+		virtual void set_tolerance(double tol);
+
+		/**
+		 * @brief Gets the local error tolerance of the adaptive time stepping.
+		 * @return The tolerance, 0 for uniform steps.
+		 */
+		double get_tolerance() const;
+
+		/**
+		 * @brief Gets the number of time steps done by the last call to `pricing()`.
+		 * @return Number of accepted time steps.
+		 */
+		int get_steps() const;
+
+		/**
+		 * @brief Sets the number of threads of the tridiagonal solve.
+		 *
+		 * The solve stays sequential when N is too small for the threads to pay off.
+		 *
+		 * @param threads Number of threads, 0 for the number of hardware threads.
+		 */
+		void set_threads(unsigned int threads);
+
+		/**
+		 * @brief Gets the number of threads of the tridiagonal solve.
+		 * @return Number of threads, 0 for the number of hardware threads.
+		 */
+		unsigned int get_threads() const;
+
+		/**
+		 * @brief Enables the Parareal sweep, parallel in time.
+		 *
+		 * The threads set with `set_threads()` are then used over the time slices, each
+		 * tridiagonal solve being sequential. The adaptive time stepping, when enabled,
+		 * takes precedence.
+		 *
+		 * @param slices Number of time slices, 1 for the serial sweep.
+		 * @param tol Tolerance on the change of the prices between two iterations.
+		 * @param coarse_steps Number of coarse time steps per slice.
+		 * @throws std::invalid_argument If `slices` or `coarse_steps` is not positive, if `tol` is negative,
+		 * or if `slices` is above 1 with a surface writer or a checkpoint set.
+		 */
+		virtual void set_parareal(int slices, double tol, int coarse_steps = 1);
+
+		/**
+		 * @brief Gets the number of iterations done by the last Parareal sweep.
+		 * @return Number of iterations, 0 if the sweep was serial.
+		 */
+		int get_iterations() const;
+
+		/**
+		 * @brief Gets the estimated speedup of the last Parareal sweep over the serial sweep.
+		 *
+		 * The serial time is not measured but extrapolated from the coarse steps of the
+		 * prediction, so the value is indicative only.
+		 * @return Estimated speedup, 1 if the sweep was serial.
+		 */
+		double get_estimated_speedup() const;
+
+		/**
+		 * @brief Records the layers of the next sweeps in a surface file.
+		 *
+		 * The layer of each time t_i is written as soon as it is computed, so the sweep must
+		 * use the uniform steps of `dt_`. The writer is not owned and must outlive the sweeps,
+		 * `SurfaceWriter::close()` being called by the caller.
+		 *
+		 * @param surface Writer created with the `Data` of this engine, null to stop recording.
+		 * @throws std::invalid_argument If `surface` is not null and the adaptive or the Parareal
+		 * sweep is enabled, see `check_sweeps()`.
+		 */
+		virtual void set_surface(SurfaceWriter* surface);
+
+		/**
+		 * @brief Checkpoints the next sweeps, and resumes them from the saved layer.
+		 *
+		 * The sweep saves its layer every `Checkpoint::get_interval()` steps. A sweep started
+		 * with the checkpoint file of the same solve on disk continues from it, the dividends
+		 * and the other settings of the engine having to be the same. The sweep must use the
+		 * uniform steps of `dt_`, as with `set_surface()`, and removes the file once complete.
+		 * The checkpoint is not owned and must outlive the sweeps.
+		 *
+		 * @param checkpoint Checkpoint, null to stop checkpointing.
+		 * @throws std::invalid_argument If `checkpoint` is not null and the adaptive or the Parareal
+		 * sweep is enabled, see `check_sweeps()`.
+		 */
+		virtual void set_checkpoint(Checkpoint* checkpoint);
+
+		/**
+		 * @brief Gets the alpha coefficients for the Crank_Nicolson scheme.
+		 * @return A vector of alpha coefficients.
+		 */
+		const std::vector<double>& get_alpha() const;
+
+		/**
+		 * @brief Gets the beta coefficients for the Crank_Nicolson scheme.
+		 * @return A vector of beta coefficients.
+		 */
+		const std::vector<double>& get_beta() const;
+
+		/**
+		 * @brief Gets the gamma coefficients for the Crank_Nicolson scheme.
+		 * @return A vector of gamma coefficients.
+		 */
+		const std::vector<double>& get_gamma() const;
+
+		/**
+		 * @brief Chooses the discretization in space.
+		 *
+		 * The coefficients and the LU factorization are computed again for the chosen scheme.
+		 *
+		 * @param compact True for the fourth-order compact scheme, false for the second-order
+		 * central scheme used by default.
+		 */
+		void set_compact(bool compact);
+
+		/**
+		 * @brief Tells whether the fourth-order compact scheme is used.
+		 * @return True for the compact scheme, false for the central one.
+		 */
+		bool get_compact() const;
+
+		/**
+		 * @brief Gets the lower matrix values of coefficients' matrix
+		 * from the LU factorization.
+		 * 
+		 * @return A vector of lower matrix values (low).
+		 */
+		const std::vector<double>& get_low() const;
+
+		/**
+		 * @brief Gets the upper matrix values of coefficients' matrix
+		 * from the LU factorization.
+		 * 
+		 * @return A vector of upper matrix values (up).
+		 */
+		const std::vector<double>& get_up() const;
+	};
 }
\ No newline at end of file
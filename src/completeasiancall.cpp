@@ -0,0 +1,229 @@
+#include "completeasiancall.h"
+
+namespace ensiie
+{
+	CompleteAsianCall::CompleteAsianCall(double T, double r, double sigma, double K, double L, double M, double N, int P, int NA) : Complete(T, r, sigma, K, L, M, N), P_(P), NA_(NA)
+	{
+		average_discretize();
+	}
+
+	CompleteAsianCall::CompleteAsianCall(const Data& d, int P, int NA) : Complete(d), P_(P), NA_(NA)
+	{
+		average_discretize();
+	}
+
+	void CompleteAsianCall::average_discretize()
+	{
+		if (P_ <= 0 || NA_ <= 0 || P_ > M_)
+		{
+			throw std::invalid_argument("P and NA must be positive and P can not exceed M");
+		}
+
+		da_ = L_ / NA_;
+
+		std::vector<double> a(NA_ + 1);
+		std::vector<int> fixing(P_);
+
+		for (int k = 0; k <= NA_; k++)
+		{
+			a[k] = k * da_;
+		}
+
+		for (int k = 1; k <= P_; k++)
+		{
+			fixing[k - 1] = (int)std::lround(k * M_ / P_);
+		}
+
+		a_ = std::move(a);
+		fixing_ = std::move(fixing);
+		levels_.assign(NA_ + 1, std::vector<double>(N_ + 1));
+		jumped_.assign(NA_ + 1, std::vector<double>(N_ + 1));
+	}
+
+	void CompleteAsianCall::level_sweep(std::vector<double>& v, double A, int n, int i_begin, int i_end,
+		const std::vector<double>& discount, const std::vector<double>& forward,
+		std::vector<double>& b, std::vector<double>& y) const
+	{
+		for (int i = i_begin + 1; i <= i_end; i++)
+		{
+			// Boundary conditions for s=0 and s=L, where the average is known or linear in s
+			double lower = discount[i] * std::max(0.0, n * A / P_ - K_);
+			double upper = discount[i] * std::max(0.0, (n * A + forward[i]) / P_ - K_);
+
+			crank_nicolson(v, 1, low_, up_, lower, upper, b, y);
+		}
+	}
+
+	int CompleteAsianCall::solve_threads() const
+	{
+		return 1;
+	}
+
+	void CompleteAsianCall::check_supported(bool used, const char* setting)
+	{
+		if (used)
+		{
+			throw std::invalid_argument(std::string(setting) + " are not supported by the Asian call");
+		}
+	}
+
+	void CompleteAsianCall::add_dividend(double t, double D)
+	{
+		(void)t;
+		(void)D;
+		check_supported(true, "The dividends");
+	}
+
+	void CompleteAsianCall::set_tolerance(double tol)
+	{
+		check_supported(tol != 0, "The adaptive time steps");
+		Complete::set_tolerance(tol);
+	}
+
+	void CompleteAsianCall::set_parareal(int slices, double tol, int coarse_steps)
+	{
+		check_supported(slices != 1, "The Parareal time slices");
+		Complete::set_parareal(slices, tol, coarse_steps);
+	}
+
+	void CompleteAsianCall::set_surface(SurfaceWriter* surface)
+	{
+		check_supported(surface != nullptr, "The surface files");
+		Complete::set_surface(surface);
+	}
+
+	void CompleteAsianCall::set_checkpoint(Checkpoint* checkpoint)
+	{
+		check_supported(checkpoint != nullptr, "The checkpoints");
+		Complete::set_checkpoint(checkpoint);
+	}
+
+	void CompleteAsianCall::pricing()
+	{
+		// In the methods the matrix levels_ has the form levels_[average levels a][raws j]
+		std::vector<std::vector<double>>& prices = levels_;
+		std::vector<std::vector<double>>& jumped = jumped_;
+
+		// Terminal condition for t=T, the last fixing being the underlying price itself
+		for (int a = 0; a <= NA_; a++)
+		{
+			for (int j = 0; j <= N_; j++)
+			{
+				prices[a][j] = std::max(0.0, a_[a] + (l_[j] - a_[a]) / P_ - K_);
+			}
+		}
+
+		unsigned int level_threads = get_level_threads();
+
+		// Scratch buffers of each thread, taken from the workspace of the calling thread
+		PricingWorkspace& workspace = PricingWorkspace::local();
+		PricingWorkspace::Scope scope(workspace);
+		std::vector<double>* scratch[2 * max_level_threads];
+		for (unsigned int p = 0; p < 2 * level_threads; p++)
+		{
+			scratch[p] = &workspace.acquire(N_ + 1);
+		}
+
+		// Discount factors from T and growth factors from 0 of each column, shared by the levels
+		std::vector<double>& discount = workspace.acquire(M_ + 1);
+		std::vector<double>& growth = workspace.acquire(M_ + 1);
+		std::vector<double>& forward = workspace.acquire(M_ + 1);
+		for (int i = 0; i <= M_; i++)
+		{
+			double t = t_[M_ - i];
+			discount[i] = std::exp(-r_ * (T_ - t));
+			growth[i] = std::exp(-r_ * t);
+		}
+
+		// Sum of exp(r t_k) over the fixings still to come
+		double fixings_to_come = 0;
+
+		int i_begin = 0;
+
+		// Segments between two fixing dates, n being the number of fixings already observed
+		for (int n = P_ - 1; n >= 0; n--)
+		{
+			int i_end = (n == 0) ? (int)M_ : (int)M_ - fixing_[n - 1];
+
+			// Expected sum of the fixings still to come for s=L
+			fixings_to_come += std::exp(r_ * t_[fixing_[n]]);
+			for (int i = i_begin + 1; i <= i_end; i++)
+			{
+				forward[i] = L_ * fixings_to_come * growth[i];
+			}
+
+			// The levels of running average are independent until the next fixing. Before the
+			// first one they all hold the same prices, so the level 0 is enough
+			int last_level = (n == 0) ? 0 : NA_;
+			unsigned int n_threads = (n == 0) ? 1 : level_threads;
+			auto solve_levels = [&](unsigned int p)
+			{
+				for (int a = p; a <= last_level; a += n_threads)
+				{
+					level_sweep(prices[a], a_[a], n, i_begin, i_end, discount, forward, *scratch[2 * p], *scratch[2 * p + 1]);
+				}
+			};
+
+			if (n_threads == 1)
+			{
+				solve_levels(0);
+			}
+			else
+			{
+				std::thread threads[max_level_threads];
+				for (unsigned int p = 0; p < n_threads; p++)
+				{
+					threads[p] = std::thread(solve_levels, p);
+				}
+				for (unsigned int p = 0; p < n_threads; p++)
+				{
+					threads[p].join();
+				}
+			}
+
+			// Jump condition at the n-th fixing date, A becoming A + (s - A) / n, for the
+			// level 0 only before the first fixing
+			if (n > 0)
+			{
+				for (int a = 0; a <= ((n == 1) ? 0 : NA_); a++)
+				{
+					for (int j = 0; j <= N_; j++)
+					{
+						double x = std::min((a_[a] + (l_[j] - a_[a]) / n) / da_, (double)NA_);
+						int k = std::min((int)x, NA_ - 1);
+						double w = x - k;
+						jumped[a][j] = (1 - w) * prices[k][j] + w * prices[k + 1][j];
+					}
+				}
+
+				std::swap(prices, jumped);
+			}
+
+			i_begin = i_end;
+		}
+
+		// Before the first fixing the price does not depend on the running average
+		this->price_ = prices[0];
+	}
+
+	unsigned int CompleteAsianCall::get_level_threads() const
+	{
+		unsigned int n_threads = (threads_ == 0) ? std::max(1u, std::thread::hardware_concurrency()) : threads_;
+		return std::min({ n_threads, (unsigned int)NA_ + 1, max_level_threads });
+	}
+
+	const std::vector<double>& CompleteAsianCall::get_price() const
+	{
+		return price_;
+	}
+
+	int CompleteAsianCall::get_P() const
+	{
+		return P_;
+	}
+
+	const std::vector<double>& CompleteAsianCall::get_a() const
+	{
+		return a_;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#pragma once
+#include "complete.h"
+#include <thread>
+
+namespace ensiie
+{
+	/**
+	* @class CompleteAsianCall
+	*
+	* @brief A class to calculate and store the price of a discretely monitored, fixed strike,
+	* arithmetic average-rate call option using Crank-Nicolson method to solve the Black-Scholes PDE.
+	*
+	* The running average A of the fixings is added as an extra state variable, discretized
+	* on a uniform grid of `NA` + 1 levels in [0, L]. Between two fixing dates A does not move, so
+	* the problem is a set of independent one-dimensional Black-Scholes PDEs in s, one per level
+	* of A, which are solved with the tridiagonal system of the `Complete` class. The levels are
+	* shared between threads. At each fixing date the jump condition
+	* V(t-, s, A) = V(t+, s, A + (s - A) / k) is applied by linear interpolation on the A grid.
+	*
+	* The fixing dates are equally spaced, t_k = k * T / P for k = 1, ..., P, rounded to the
+	* nearest time step, the last one being the maturity. Before the first fixing, the levels
+	* all hold the same prices, so only the level 0 is solved.
+	*
+	* The threads set with `set_threads()` share the levels, each tridiagonal solve being
+	* sequential. The dividends, the adaptive and Parareal sweeps, the surface writer and the
+	* checkpoint of `Complete` are not supported by the levels and their setters throw.
+	*/
+	class CompleteAsianCall : public Complete
+	{
+		/** @brief A vector to store the prices of the asian call option at time 0 and different price steps */
+		std::vector<double> price_;
+
+		static const unsigned int max_level_threads = 64; /**< Maximum number of threads sharing the levels of running average.*/
+
+		int P_; /**< Number of fixing dates.*/
+		int NA_; /**< Number of steps in the running average discretization.*/
+		double da_; /**< Lenght of the step in running average.*/
+		std::vector<double> a_; /**< Discretized running average vector.*/
+		std::vector<int> fixing_; /**< Time index of each fixing date, fixing_[k - 1] for the k-th one.*/
+		std::vector<std::vector<double>> levels_; /**< Prices of each level of running average, kept between the pricings.*/
+		std::vector<std::vector<double>> jumped_; /**< Prices of each level after the jump condition, kept between the pricings.*/
+
+		/**
+		 * @brief Computes the fixing dates and discretizes the running average domain.
+		 *
+		 * The prices of the levels are allocated here once, so that repeated pricings
+		 * do not allocate memory.
+		 *
+		 * @throws std::invalid_argument If `P` or `NA` is not positive or if `P` is greater than `M`.
+		 */
+		void average_discretize();
+
+		/**
+		 * @brief Solves the PDE for one level of running average between two fixing dates.
+		 *
+		 * @param v Prices of the level, overwritten column after column.
+		 * @param A Running average of the level.
+		 * @param n Number of fixings already observed in the segment.
+		 * @param i_begin Column at which the segment starts.
+		 * @param i_end Column at which the segment ends.
+		 * @param discount Discount factor from T of each column, shared by the levels.
+		 * @param forward Expected sum of the fixings still to come for s=L of each column of the segment, shared by the levels.
+		 * @param b Scratch vector for the right-hand side.
+		 * @param y Scratch vector for the forward substitution.
+		 */
+		void level_sweep(std::vector<double>& v, double A, int n, int i_begin, int i_end,
+			const std::vector<double>& discount, const std::vector<double>& forward,
+			std::vector<double>& b, std::vector<double>& y) const;
+
+		/**
+		 * @brief Keeps each tridiagonal solve sequential, the threads being used over the levels.
+		 * @return 1.
+		 */
+		int solve_threads() const override;
+
+		/**
+		 * @brief Throws if a setting of `Complete` not supported by the levels is used.
+		 *
+		 * @param used True if the setting is used.
+		 * @param setting Name of the setting, for the message.
+		 * @throws std::invalid_argument If `used` is true.
+		 */
+		static void check_supported(bool used, const char* setting);
+
+	public:
+
+		/**
+		* @brief Constructs a CompleteAsianCall object using financial parameters.
+		*
+		* @param T Time to maturity (in years)
+		* @param r Market Risk-free interest rate
+		* @param sigma Volatility of the underlying asset
+		* @param K Strike price of the option
+		* @param L Maximum value of the underlying asset
+		* @param M Number of time steps
+		* @param N Number of price steps
+		* @param P Number of fixing dates
+		* @param NA Number of running average steps
+		*/
+		CompleteAsianCall(double T, double r, double sigma, double K, double L, double M, double N, int P, int NA);
+
+		/**
+		 * @brief Constructs a CompleteAsianCall object using an existing Data object.
+		 *
+		 * @param d A `Data` object containing the financial parameters for the model
+		 * @param P Number of fixing dates
+		 * @param NA Number of running average steps
+		 */
+		CompleteAsianCall(const Data& d, int P, int NA);
+
+		/**
+		 * @brief Rejects the dividends, which are not supported.
+		 * @throws std::invalid_argument Always.
+		 */
+		void add_dividend(double t, double D) override;
+
+		/**
+		 * @brief Rejects the adaptive time stepping, which is not supported.
+		 * @param tol Tolerance, only 0 being accepted.
+		 * @throws std::invalid_argument If `tol` is not 0.
+		 */
+		void set_tolerance(double tol) override;
+
+		/**
+		 * @brief Rejects the Parareal sweep, which is not supported.
+		 * @param slices Number of time slices, only 1 being accepted.
+		 * @param tol Tolerance on the change of the prices between two iterations.
+		 * @param coarse_steps Number of coarse time steps per slice.
+		 * @throws std::invalid_argument If `slices` is not 1.
+		 */
+		void set_parareal(int slices, double tol, int coarse_steps = 1) override;
+
+		/**
+		 * @brief Rejects the surface writer, which is not supported.
+		 * @param surface Writer, only null being accepted.
+		 * @throws std::invalid_argument If `surface` is not null.
+		 */
+		void set_surface(SurfaceWriter* surface) override;
+
+		/**
+		 * @brief Rejects the checkpoint, which is not supported.
+		 * @param checkpoint Checkpoint, only null being accepted.
+		 * @throws std::invalid_argument If `checkpoint` is not null.
+		 */
+		void set_checkpoint(Checkpoint* checkpoint) override;
+
+		/**
+		 * @brief Computes the price of the asian call option using the Crank-Nicolson method.
+		 *
+		 * The levels of running average are solved in parallel between two fixing dates,
+		 * and the jump conditions are applied sequentially at the fixing dates.
+		 */
+		void pricing() override;
+
+		/**
+		 * @brief Retrieves the computed prices of the asian call option A(0, s), which are prices
+		 * at time 0 for each level of underlying price s.
+		 *
+		 * @return A vector containing the prices of the asian call option at time 0.
+		 */
+		const std::vector<double>& get_price() const;
+
+		/**
+		 * @brief Gets the number of fixing dates.
+		 * @return Number of fixing dates (P).
+		 */
+		int get_P() const;
+
+		/**
+		 * @brief Gets the discretized running average vector.
+		 * @return Discretized running average vector (a).
+		 */
+		const std::vector<double>& get_a() const;
+
+		/**
+		 * @brief Gets the number of threads sharing the levels of running average.
+		 *
+		 * The number set with `set_threads()`, the hardware threads by default, bounded by the
+		 * number of levels. With more than one, each pricing launches this many threads per
+		 * segment between two fixing dates, except the one before the first fixing, a launch
+		 * allocating the state of the thread. With one, the levels are solved by the calling thread.
+		 *
+		 * @return The number of threads, at most the number of levels.
+		 */
+		unsigned int get_level_threads() const;
+	};
+}
\ No newline at end of file
@@ -1,79 +1,35 @@
-#include "completeput.h"
-
-
-namespace ensiie
-{
-	CompletePut::CompletePut(double T, double r, double sigma, double K, double L, double M, double N) : Complete(T, r, sigma, K, L, M, N) {};
-	CompletePut::CompletePut(const Data& d) : Complete(d) {};
-
-	void CompletePut::pricing()
-	{
-
-		// In the methods the matrix prices has the form prices[raws j],[columns i]
-		std::vector<std::vector<double>> prices(N_ + 1, std::vector<double>(M_ + 1));
-		std::vector<double> b(N_ + 1);
-		std::vector<double> y(N_ + 1);
-
-		// Boundary conditions for s=0
-		for (int i = 0; i <= M_; i++)
-		{
-			prices[0][i] = K_ * std::exp(-r_ * (T_ - t_[M_ - i]));
-		}
-
-		// Boundary condition for t=T
-		for (int j = 1; j < N_; j++)
-		{
-			prices[j][0] = std::max(0.0, K_ - l_[j]);
-		}
-
-		// Boundary condition for s=L
-		for (int i = 0; i <= M_; i++)
-		{
-			prices[N_][i] = 0;
-		}
-
-		// Iterative solution of the matrix prices by column
-		for (int i = 1; i <= M_; i++) {
-
-			// Solution to the problem Ly=b, comuting b and then y
-			for (int j = 0; j <= N_; j++)
-			{
-				if (j == 0)
-				{
-					b[j] = prices[j][i - 1] * (1 + beta_[j]) + prices[j + 1][i - 1] * gamma_[j];
-					y[j] = b[j];
-				}
-				else if (j == N_)
-				{
-					b[j] = prices[j][i - 1] * (1 + beta_[j]) + prices[j - 1][i - 1] * alpha_[j];
-					y[j] = b[j] - low_[j] * y[j - 1];
-				}
-				else
-				{
-					b[j] = prices[j][i - 1] * (1 + beta_[j]) + prices[j + 1][i - 1] * gamma_[j] + prices[j - 1][i - 1] * alpha_[j];
-					y[j] = b[j] - low_[j] * y[j - 1];
-				}
-			}
-
-			// Solution to the problem Ux=y
-			for (int j = (N_ - 1); j > 0; j--)
-			{
-				prices[j][i] = (y[j] + gamma_[j] * prices[j + 1][i]) / up_[j];
-			}
-		}
-
-		// Extraction of the column of the matrix corresponding to P(0, s)
-		std::vector<double> price(N_ + 1);
-		for (int i = 0; i <= N_; i++)
-		{
-			price[i] = prices[i][M_];
-		}
-
-		this->price_ = price;
-	}
-
-	std::vector<double> CompletePut::get_price() const
-	{
-		return price_;
-	}
+#include "completeput.h"
+
+
+namespace ensiie
+{
+	CompletePut::CompletePut(double T, double r, double sigma, double K, double L, double M, double N) : Complete(T, r, sigma, K, L, M, N) {};
+	CompletePut::CompletePut(const Data& d) : Complete(d) {};
+
+	double CompletePut::payoff(double s) const
+	{
+		return std::max(0.0, K_ - s);
+	}
+
+	double CompletePut::lower_boundary(double t) const
+	{
+		return K_ * discount(t);
+	}
+
+	double CompletePut::upper_boundary(double t) const
+	{
+		(void)t;
+		return 0;
+	}
+
+	void CompletePut::pricing()
+	{
+		// Backward sweep from T to 0, the boundary conditions being given by the methods above
+		sweep(this->price_);
+	}
+
+	const std::vector<double>& CompletePut::get_price() const
+	{
+		return price_;
+	}
 }
\ No newline at end of file
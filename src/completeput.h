@@ -1,65 +1,86 @@
-#pragma once
-#include "complete.h"
-
-namespace ensiie
-{
-	/**
-	* @class CompletePut
-	*
-	* @brief A class to calculate and store the price of a European put option
-	* using Crank-Nicolson method to solve the Black-Scholes PDE.
-	*
-	* This class is derived from the `Complete` class and implements the specific
-	* pricing algorithm for a European put option, including the computation of
-	* boundary conditions and the solution of the PDE using LU factorization.
-	*/
-	class CompletePut : public Complete
-	{
-		/** @brief A vector to store the prices of the put option at time 0 and different time steps */
-		std::vector<double> price_;
-
-	public:
-
-		/**
-		* @brief Constructs a CompletePut object using financial parameters.
-		*
-		* Initializes the financial parameters for the option pricing model and
-		* calculates the coefficients and LU factorization.
-		*
-		* @param T Time to maturity (in years)
-		* @param r Market Risk-free interest rate
-		* @param sigma Volatility of the underlying asset
-		* @param K Strike price of the option
-		* @param L Maximum value of the underlying asset
-		* @param M Number of time steps
-		* @param N Number of price steps
-		*/
-		CompletePut(double T, double r, double sigma, double K, double L, double M, double N);
-
-		/**
-		 * @brief Constructs a CompletePut object using an existing Data object.
-		 *
-		 * This constructor initializes the model using an existing `Data` object
-		 * and calculates the coefficients and LU factorization.
-		 *
-		 * @param d A `Data` object containing the financial parameters for the model
-		 */
-		CompletePut(const Data& d);
-
-		/**
-		 * @brief Computes the price of the European put option using the Crank-Nicolson method.
-		 *
-		 * This method uses boundary conditions, LU factorization, and a system of equations
-		 * to solve for the price of the European put option over a grid of time and price steps.
-		 */
-		void pricing() override;
-
-		/**
-		 * @brief Retrieves the computed prices of the put option P(0, s), which are prices
-		 * at time 0 for each level of underlying price s.
-		 *
-		 * @return A vector containing the prices of the put option at time 0.
-		 */
-		std::vector<double> get_price() const;
-	};
+#pragma once
+#include "complete.h"
+
+namespace ensiie
+{
+	/**
+	* @class CompletePut
+	*
+	* @brief A class to calculate and store the price of a European put option
+	* using Crank-Nicolson method to solve the Black-Scholes PDE.
+	*
+	* This class is derived from the `Complete` class and implements the specific
+	* pricing algorithm for a European put option, including the computation of
+	* boundary conditions and the solution of the PDE using LU factorization.
+	*/
+	class CompletePut : public Complete
+	{
+		/** @brief A vector to store the prices of the put option at time 0 and different time steps */
+		std::vector<double> price_;
+
+		/**
+		 * @brief Computes the payoff of the put option at maturity.
+		 * @param s Underlying asset price.
+		 * @return The payoff max(K - s, 0).
+		 */
+		double payoff(double s) const override;
+
+		/**
+		 * @brief Computes the boundary condition for s=0.
+		 * @param t Time.
+		 * @return The discounted strike K * e^(-r(T-t)).
+		 */
+		double lower_boundary(double t) const override;
+
+		/**
+		 * @brief Computes the boundary condition for s=L.
+		 * @param t Time.
+		 * @return The price 0, the put being worthless.
+		 */
+		double upper_boundary(double t) const override;
+
+	public:
+
+		/**
+		* @brief Constructs a CompletePut object using financial parameters.
+		*
+		* Initializes the financial parameters for the option pricing model and
+		* calculates the coefficients and LU factorization.
+		*
+		* @param T Time to maturity (in years)
+		* @param r Market Risk-free interest rate
+		* @param sigma Volatility of the underlying asset
+		* @param K Strike price of the option
+		* @param L Maximum value of the underlying asset
+		* @param M Number of time steps
+		* @param N Number of price steps
+		*/
+		CompletePut(double T, double r, double sigma, double K, double L, double M, double N);
+
+		/**
+		 * @brief Constructs a CompletePut object using an existing Data object.
+		 *
+		 * This constructor initializes the model using an existing `Data` object
+		 * and calculates the coefficients and LU factorization.
+		 *
+		 * @param d A `Data` object containing the financial parameters for the model
+		 */
+		CompletePut(const Data& d);
+
+		/**
+		 * @brief Computes the price of the European put option using the Crank-Nicolson method.
+		 *
+		 * This method uses boundary conditions, LU factorization, and a system of equations
+		 * to solve for the price of the European put option over a grid of time and price steps.
+		 */
+		void pricing() override;
+
+		/**
+		 * @brief Retrieves the computed prices of the put option P(0, s), which are prices
+		 * at time 0 for each level of underlying price s.
+		 *
+		 * @return A vector containing the prices of the put option at time 0.
+		 */
+		const std::vector<double>& get_price() const;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "cos.h"
+
+namespace ensiie
+{
+	Cos::Cos(double T, double r, double sigma, double K, double L, double M, double N, int n_terms, double truncation) : Data(T, r, sigma, K, L, M, N), n_terms_(n_terms), truncation_(truncation)
+	{
+		if (n_terms <= 0 || truncation <= 0)
+		{
+			throw std::invalid_argument("The number of terms and the truncation must be positive");
+		}
+	}
+
+	Cos::Cos(const Data& d, int n_terms, double truncation) : Data(d), n_terms_(n_terms), truncation_(truncation)
+	{
+		if (n_terms <= 0 || truncation <= 0)
+		{
+			throw std::invalid_argument("The number of terms and the truncation must be positive");
+		}
+	}
+
+	std::vector<double> Cos::unit_put(const std::vector<double>& x) const
+	{
+		const double pi = 3.141592653589793;
+
+		int n = (int)x.size();
+		std::vector<double> price(n, 0);
+		if (n == 0)
+		{
+			return price;
+		}
+
+		// Truncation interval of the log-return z = log(S_T / S0), centred on its mean, so that
+		// its width and the number of terms it needs do not depend on the ladder
+		double c1 = (r_ - 0.5 * sigma_ * sigma_) * T_;
+		double width = truncation_ * sigma_ * std::sqrt(T_);
+		double a = c1 - width;
+		double b = c1 + width;
+
+		// Payoff max(1 - e^(x + z), 0) on [a, c], c being the log-moneyness of the strike clamped to
+		// the interval, with the cos(k delta) and sin(k delta) of the coefficients by angle addition
+		std::vector<double> cos_k(n), sin_k(n), cos_delta(n), sin_delta(n), exp_c(n), exp_a(n), length(n);
+		for (int j = 0; j < n; j++)
+		{
+			double c = std::min(std::max(-x[j], a), b);
+			double delta = pi * (c - a) / (b - a);
+			cos_k[j] = 1;
+			sin_k[j] = 0;
+			cos_delta[j] = std::cos(delta);
+			sin_delta[j] = std::sin(delta);
+			exp_c[j] = std::exp(x[j] + c);
+			exp_a[j] = std::exp(x[j] + a);
+			length[j] = c - a;
+		}
+
+		// First term, with half weight
+		double weight = 1 / (b - a);
+		for (int j = 0; j < n; j++)
+		{
+			price[j] = weight * (length[j] - exp_c[j] + exp_a[j]);
+		}
+
+		// Term after term over the ladder, the density coefficient Re(phi(u_k) e^(-i u_k a)) being
+		// real since the interval is centred on the mean
+		for (int k = 1; k < n_terms_; k++)
+		{
+			double u = k * pi / (b - a);
+			double density = 2 / (b - a) * std::exp(-0.5 * sigma_ * sigma_ * T_ * u * u) * std::cos(u * width);
+			double inv_u = 1 / u;
+			double inv_norm = 1 / (1 + u * u);
+			double u_norm = u * inv_norm;
+
+			for (int j = 0; j < n; j++)
+			{
+				double cos_next = cos_k[j] * cos_delta[j] - sin_k[j] * sin_delta[j];
+				double sin_next = sin_k[j] * cos_delta[j] + cos_k[j] * sin_delta[j];
+				cos_k[j] = cos_next;
+				sin_k[j] = sin_next;
+
+				double psi = sin_k[j] * inv_u;
+				double chi = (cos_k[j] * exp_c[j] - exp_a[j]) * inv_norm + sin_k[j] * exp_c[j] * u_norm;
+				price[j] += density * (psi - chi);
+			}
+		}
+
+		double discount = std::exp(-r_ * T_);
+		for (int j = 0; j < n; j++)
+		{
+			price[j] = std::max(0.0, discount * price[j]);
+		}
+
+		return price;
+	}
+
+	void Cos::pricing()
+	{
+		std::vector<double> x(N_);
+		for (int j = 1; j <= N_; j++)
+		{
+			x[j - 1] = std::log(l_[j] / K_);
+		}
+
+		std::vector<double> unit = unit_put(x);
+		std::vector<double> call(N_ + 1), put(N_ + 1);
+		double discounted_K = K_ * std::exp(-r_ * T_);
+
+		// s=0 can not be transformed, its prices are known
+		put[0] = discounted_K;
+		call[0] = 0;
+
+		for (int j = 1; j <= N_; j++)
+		{
+			put[j] = K_ * unit[j - 1];
+			call[j] = std::max(0.0, put[j] + l_[j] - discounted_K);
+		}
+
+		call_price_ = std::move(call);
+		put_price_ = std::move(put);
+	}
+
+	std::vector<double> Cos::put_ladder(double S0, const std::vector<double>& strikes) const
+	{
+		std::vector<double> x(strikes.size());
+		for (int j = 0; j < (int)strikes.size(); j++)
+		{
+			x[j] = std::log(S0 / strikes[j]);
+		}
+
+		std::vector<double> put = unit_put(x);
+		for (int j = 0; j < (int)strikes.size(); j++)
+		{
+			put[j] *= strikes[j];
+		}
+
+		return put;
+	}
+
+	std::vector<double> Cos::call_ladder(double S0, const std::vector<double>& strikes) const
+	{
+		std::vector<double> call = put_ladder(S0, strikes);
+		double discount = std::exp(-r_ * T_);
+
+		// Put-call parity, the put expansion being the most stable
+		for (int j = 0; j < (int)strikes.size(); j++)
+		{
+			call[j] = std::max(0.0, call[j] + S0 - strikes[j] * discount);
+		}
+
+		return call;
+	}
+
+	const std::vector<double>& Cos::get_call_price() const
+	{
+		return call_price_;
+	}
+
+	const std::vector<double>& Cos::get_put_price() const
+	{
+		return put_price_;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+#include "data.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ensiie
+{
+	/**
+	 * @class Cos
+	 * @brief A class to calculate the prices of European options with the Fourier-cosine (COS) expansion.
+	 *
+	 * The `Cos` class extends the `Data` class and provides a fast pricing engine for plain
+	 * European payoffs, alongside the `Complete` and `Reduced` engines.
+	 *
+	 * @details
+	 * The density of the log-return z = log(S_T / S0) is expanded in a cosine series on the
+	 * interval [a, b] centred on its mean, of half width `truncation` standard deviations. The
+	 * put price with x = log(S0 / K) is then e^(-rT) * K * sum'_k A_k V_k(x), where A_k are the
+	 * cosine coefficients of the density, known from its characteristic function, and V_k(x)
+	 * those of the put payoff max(1 - e^(x + z), 0) with unit strike. The call prices follow by
+	 * put-call parity.
+	 *
+	 * Since the interval does not depend on the strikes, the number of terms resolves the density
+	 * whatever the maturity and the width of the ladder. The A_k are shared by every (spot, strike)
+	 * pair, the V_k(x) only need the cosine and sine of k times an angle of the pair, which are
+	 * advanced by angle addition, and the sum is evaluated term after term over all the pairs,
+	 * so that the inner loop is vectorizable arithmetic without any trigonometric call.
+	 */
+	class Cos : public Data
+	{
+	protected:
+		int n_terms_; /**< Number of terms of the cosine expansion.*/
+		double truncation_; /**< Half width of the truncation interval, in standard deviations.*/
+		std::vector<double> call_price_;
+		std::vector<double> put_price_;
+
+		/**
+		 * @brief Computes the put prices with unit strike for a set of log-moneyness values.
+		 *
+		 * @param x Vector of log-moneyness values log(S0 / K).
+		 * @return A vector containing the put prices with unit strike.
+		 */
+		std::vector<double> unit_put(const std::vector<double>& x) const;
+
+	public:
+
+		/**
+		 * @brief Constructs a Cos object using financial parameters.
+		 *
+		 * @param T Time to maturity (in years)
+		 * @param r Market Risk-free interest rate
+		 * @param sigma Volatility of the underlying asset
+		 * @param K Strike price of the option
+		 * @param L Maximum value of the underlying asset
+		 * @param M Number of time steps
+		 * @param N Number of price steps
+		 * @param n_terms Number of terms of the cosine expansion
+		 * @param truncation Half width of the truncation interval, in standard deviations
+		 *
+		 * @throws std::invalid_argument If `n_terms` or `truncation` is not positive.
+		 */
+		Cos(double T, double r, double sigma, double K, double L, double M, double N, int n_terms = 512, double truncation = 10);
+
+		/**
+		 * @brief Constructs a Cos object using an existing Data object.
+		 *
+		 * @param d A `Data` object containing the financial parameters for the model
+		 * @param n_terms Number of terms of the cosine expansion
+		 * @param truncation Half width of the truncation interval, in standard deviations
+		 *
+		 * @throws std::invalid_argument If `n_terms` or `truncation` is not positive.
+		 */
+		Cos(const Data& d, int n_terms = 512, double truncation = 10);
+
+		/**
+		 * @brief Computes the prices of the European call and put options at time 0
+		 * for each level of underlying price of the grid `l_`.
+		 */
+		void pricing();
+
+		/**
+		 * @brief Computes the prices of European call options on a ladder of strikes.
+		 *
+		 * @param S0 Spot price of the underlying asset.
+		 * @param strikes Vector of strikes.
+		 * @return A vector containing the call prices, in the order of the strikes.
+		 */
+		std::vector<double> call_ladder(double S0, const std::vector<double>& strikes) const;
+
+		/**
+		 * @brief Computes the prices of European put options on a ladder of strikes.
+		 *
+		 * @param S0 Spot price of the underlying asset.
+		 * @param strikes Vector of strikes.
+		 * @return A vector containing the put prices, in the order of the strikes.
+		 */
+		std::vector<double> put_ladder(double S0, const std::vector<double>& strikes) const;
+
+		/**
+		 * @brief Retrieves the computed prices of the call option C(0, s).
+		 * @return A vector containing the prices of the call option at time 0.
+		 */
+		const std::vector<double>& get_call_price() const;
+
+		/**
+		 * @brief Retrieves the computed prices of the put option P(0, s).
+		 * @return A vector containing the prices of the put option at time 0.
+		 */
+		const std::vector<double>& get_put_price() const;
+	};
+}
\ No newline at end of file
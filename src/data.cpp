@@ -1,110 +1,152 @@
-#include "data.h"
-
-namespace ensiie
-{
-
-	void Data::discretize()
-	{
-
-		dt_ = T_ / M_;
-		ds_ = L_ / N_;
-
-		std::vector<double> t(M_ + 1);
-		std::vector<double> l(N_ + 1);
-
-		for (int i = 0; i <= M_; i++)
-		{
-			t[i] = i * dt_;
-		}
-
-		for (int i = 0; i <= N_; i++)
-		{
-			l[i] = i * ds_;
-		}
-
-		t_ = t;
-		l_ = l;
-	}
-
-	Data::Data(double T, double r, double sigma, double K, double L, double M, double N)
-	{
-
-		// Excpetion for negative values
-		if (T < 0 || r < 0 || sigma < 0 || K < 0 || L < 0 || M < 0 || N < 0)
-		{
-			throw std::invalid_argument("Values must be non-negative");
-		}
-		// Exception for null number of steps
-		else if (M == 0 || N == 0 || sigma == 0 || K == 0)
-		{
-			throw std::invalid_argument("M, N, sigma and K must be positive");
-		}
-		else
-		{
-			T_ = T;
-			r_ = r;
-			sigma_ = sigma;
-			K_ = K;
-			L_ = L;
-			M_ = M;
-			N_ = N;
-
-			discretize();
-		}
-	}
-
-	double Data::get_T() const
-	{
-		return T_;
-	};
-
-	double Data::get_r() const 
-	{
-		return r_;
-	}
-
-	double Data::get_sigma() const
-	{
-		return sigma_;
-	}
-
-	double Data::get_K() const
-	{
-		return K_;
-	}
-
-	double Data::get_L() const
-	{
-		return L_;
-	}
-
-	double Data::get_M() const
-	{
-		return M_;
-	}
-
-	double Data::get_N() const
-	{
-		return N_;
-	}
-
-	double Data::get_dt() const
-	{
-		return dt_;
-	}
-
-	double Data::get_ds() const
-	{
-		return ds_;
-	}
-
-	std::vector<double> Data::get_t() const
-	{
-		return t_;
-	}
-
-	std::vector<double> Data::get_l() const
-	{
-		return l_;
-	}
+#include "data.h"
+#include "profile.h"
+#include "vmath.h"
+
+namespace ensiie
+{
+
+	void Data::discretize()
+	{
+		ENSIIE_PROFILE_SCOPE(discretize, M_ + N_ + 2);
+
+		dt_ = T_ / M_;
+		ds_ = L_ / N_;
+
+		// The grid is built in place, then shared by all the copies of the object
+		auto grid = std::make_shared<Grid>();
+		grid->t.resize(M_ + 1);
+		grid->l.resize(N_ + 1);
+
+		for (int i = 0; i <= M_; i++)
+		{
+			grid->t[i] = i * dt_;
+		}
+
+		for (int i = 0; i <= N_; i++)
+		{
+			grid->l[i] = i * ds_;
+		}
+
+		// Discount factors of the time grid, by a single vectorized exponential
+		grid->discount.resize(M_ + 1);
+		for (int i = 0; i <= M_; i++)
+		{
+			grid->discount[i] = -r_ * (T_ - grid->t[i]);
+		}
+		vector_exp(grid->discount.data(), grid->discount.data(), grid->discount.size());
+
+		grid_ = std::move(grid);
+		t_ = Span(grid_->t);
+		l_ = Span(grid_->l);
+	}
+
+	Data::Data(double T, double r, double sigma, double K, double L, double M, double N)
+	{
+
+		// Excpetion for negative values
+		if (T < 0 || r < 0 || sigma < 0 || K < 0 || L < 0 || M < 0 || N < 0)
+		{
+			throw std::invalid_argument("Values must be non-negative");
+		}
+		// Exception for null number of steps
+		else if (M == 0 || N == 0 || sigma == 0 || K == 0)
+		{
+			throw std::invalid_argument("M, N, sigma and K must be positive");
+		}
+		else
+		{
+			T_ = T;
+			r_ = r;
+			sigma_ = sigma;
+			K_ = K;
+			L_ = L;
+			M_ = M;
+			N_ = N;
+
+			discretize();
+		}
+	}
+
+	Data::Data(const Data& d, double r, double sigma) : Data(d)
+	{
+		if (r < 0 || sigma <= 0)
+		{
+			throw std::invalid_argument("r must be non-negative and sigma positive");
+		}
+
+		r_ = r;
+		sigma_ = sigma;
+
+		if (r != d.r_)
+		{
+			discretize();
+		}
+	}
+
+	double Data::discount(double t) const
+	{
+		long i = (dt_ > 0) ? std::lround(t / dt_) : 0;
+
+		if (i >= 0 && i <= M_ && grid_->t[i] == t)
+		{
+			return grid_->discount[i];
+		}
+
+		return std::exp(-r_ * (T_ - t));
+	}
+
+	double Data::get_T() const
+	{
+		return T_;
+	};
+
+	double Data::get_r() const 
+	{
+		return r_;
+	}
+
+	double Data::get_sigma() const
+	{
+		return sigma_;
+	}
+
+	double Data::get_K() const
+	{
+		return K_;
+	}
+
+	double Data::get_L() const
+	{
+		return L_;
+	}
+
+	double Data::get_M() const
+	{
+		return M_;
+	}
+
+	double Data::get_N() const
+	{
+		return N_;
+	}
+
+	double Data::get_dt() const
+	{
+		return dt_;
+	}
+
+	double Data::get_ds() const
+	{
+		return ds_;
+	}
+
+	const std::vector<double>& Data::get_t() const
+	{
+		return grid_->t;
+	}
+
+	const std::vector<double>& Data::get_l() const
+	{
+		return grid_->l;
+	}
 }
\ No newline at end of file
@@ -1,122 +1,204 @@
-#pragma once
-#include <vector>
-#include <stdexcept>
-
-namespace ensiie
-{
-	/**
-	* @class Data
-	* @brief Contains all the data needed to solve the Black-Scholes pde.
-	* 
-	* It also discretize the domain in time and asset value. 
-	*/
-	class Data
-	{
-	protected:
-		double T_; /**< Time to maturity.*/
-		double r_; /**< Market risk-free interest rate.*/
-		double sigma_; /**< Underlying asset volatility.*/
-		double K_; /**< Strike price of the option.*/
-		double L_; /**< Underlying asset maximum price.*/
-		double M_; /**< Number of steps in time discretization.*/
-		double N_; /**< Number of steps in asset price discretization.*/
-		double dt_; /**< Lenght of the step in time.*/
-		double ds_; /**< Lenght of the step in asset's value.*/
-		std::vector<double> t_; /**< Discretized time vector.*/
-		std::vector<double> l_; /**< Discretized asset price vector.*/
-
-		/**
-		 * @brief Discretizes the time and space domains based on the parameters of the model.
-		 *
-		 * This method calculates the time step (`dt_`) and space step (`ds_`)
-		 * and fills the vectors `t_` and `l_` with the discretized values.
-		 */
-		void discretize();
-		
-	public:
-		/**
-		 * @brief Constructs a Data object with the specified parameters.
-		 * 
-		 * Initializes the parameters of the model and calls the `discretize()` method 
-		 * to set up the time and space discretization.
-		 * 
-		 * @param T Total time to maturity (in years).
-		 * @param r Market risk-free interest rate.
-		 * @param sigma Volatility of the underlying asset.
-		 * @param K Strike price of the option.
-		 * @param L Maximum asset price considered in the model.
-		 * @param M Number of time steps in the discretization.
-		 * @param N Number of asset price steps in the discretization.
-		 *
-		 * @throws std::invalid_argument If any parameter is negative, or if `M` or `N` is zero.
-		 */
-		Data(double T, double r, double sigma, double K, double L, double M, double N);
-
-		/**
-		 * @brief Gets the total time to maturity.
-		 * @return Total time to maturity (T).
-		 */
-		double get_T() const;
-
-		/**
-		 * @brief Gets the market risk-free interest rate.
-		 * @return Market risk-free interest rate (r).
-		 */
-		double get_r() const;
-
-		/**
-		 * @brief Gets the volatility of the underlying asset.
-		 * @return Volatility (sigma).
-		 */
-		double get_sigma() const;
-
-		/**
-		 * @brief Gets the strike price of the option.
-		 * @return Strike price (K).
-		 */
-		double get_K() const;
-
-		/**
-		 * @brief Gets the maximum asset price considered in the model.
-		 * @return Maximum asset price (L).
-		 */
-		double get_L() const;
-
-		/**
-		 * @brief Gets the number of time steps in the discretization.
-		 * @return Number of time steps (M).
-		 */
-		double get_M() const;
-
-		/**
-		 * @brief Gets the number of asset price steps in the discretization.
-		 * @return Number of asset price steps (N).
-		 */
-		double get_N() const;
-
-		/**
-		* @brief Gets the time step size.
-		* @return Time step size (dt).
-		*/
-		double get_dt() const;
-
-		/**
-		 * @brief Gets the asset price step size.
-		 * @return Asset price step size (ds).
-		 */
-		double get_ds() const;
-
-		/**
-		 * @brief Gets the discretized time vector.
-		 * @return Discretized time vector (t).
-		 */
-		std::vector<double> get_t() const;
-
-		/**
-		 * @brief Gets the discretized asset price vector.
-		 * @return Discretized asset price vector (l).
-		 */
-		std::vector<double> get_l() const;
-
-	};
+#pragma once
+#include <vector>
+#include <stdexcept>
+#include <memory>
+#include <cstddef>
+#include <cmath>
+
+namespace ensiie
+{
+	/**
+	* @class Span
+	* @brief A read-only view over a contiguous sequence of values owned elsewhere.
+	*
+	* It is used to index the shared grids without copying them. The accessors are defined
+	* in the class so that the indexing is inlined in the loops of the engines.
+	*/
+	class Span
+	{
+		const double* data_; /**< First value of the sequence.*/
+		std::size_t size_; /**< Number of values.*/
+
+	public:
+		/**
+		 * @brief Constructs an empty view.
+		 */
+		Span() : data_(nullptr), size_(0) {};
+
+		/**
+		 * @brief Constructs a view over the values of a vector, which must outlive it.
+		 * @param v The viewed vector.
+		 */
+		Span(const std::vector<double>& v) : data_(v.data()), size_(v.size()) {};
+
+		/**
+		 * @brief Constructs a view over an array, which must outlive it.
+		 * @param data First value of the array.
+		 * @param size Number of values.
+		 */
+		Span(const double* data, std::size_t size) : data_(data), size_(size) {};
+
+		double operator[](std::size_t i) const { return data_[i]; }
+		std::size_t size() const { return size_; }
+		const double* data() const { return data_; }
+		const double* begin() const { return data_; }
+		const double* end() const { return data_ + size_; }
+	};
+
+	/**
+	* @struct Grid
+	* @brief Discretized time and asset price vectors, immutable once built.
+	*
+	* A grid is shared by all the copies of a `Data` object, so that the engines built from
+	* the same `Data` do not allocate their own. It also holds the discount factors of the
+	* time grid, computed once in a vectorized loop and reused by every engine and every call.
+	*/
+	struct Grid
+	{
+		std::vector<double> t; /**< Discretized time vector.*/
+		std::vector<double> l; /**< Discretized asset price vector.*/
+		std::vector<double> discount; /**< Discount factors e^(-r(T-t)) of the time grid.*/
+	};
+
+	/**
+	* @class Data
+	* @brief Contains all the data needed to solve the Black-Scholes pde.
+	* 
+	* It also discretize the domain in time and asset value. 
+	*/
+	class Data
+	{
+	protected:
+		double T_; /**< Time to maturity.*/
+		double r_; /**< Market risk-free interest rate.*/
+		double sigma_; /**< Underlying asset volatility.*/
+		double K_; /**< Strike price of the option.*/
+		double L_; /**< Underlying asset maximum price.*/
+		double M_; /**< Number of steps in time discretization.*/
+		double N_; /**< Number of steps in asset price discretization.*/
+		double dt_; /**< Lenght of the step in time.*/
+		double ds_; /**< Lenght of the step in asset's value.*/
+		std::shared_ptr<const Grid> grid_; /**< Discretized domain, shared by the copies.*/
+		Span t_; /**< Discretized time vector, view over the shared grid.*/
+		Span l_; /**< Discretized asset price vector, view over the shared grid.*/
+
+		/**
+		 * @brief Discretizes the time and space domains based on the parameters of the model.
+		 *
+		 * This method calculates the time step (`dt_`) and space step (`ds_`)
+		 * and builds the shared grid, viewed by `t_` and `l_`.
+		 */
+		void discretize();
+
+		/**
+		 * @brief Gets the discount factor from a time to maturity.
+		 *
+		 * The factors of the dates of the time grid are read from the shared grid, the others
+		 * are computed on the fly.
+		 *
+		 * @param t Time.
+		 * @return The discount factor e^(-r(T-t)).
+		 */
+		double discount(double t) const;
+		
+	public:
+		/**
+		 * @brief Constructs a Data object with the specified parameters.
+		 * 
+		 * Initializes the parameters of the model and calls the `discretize()` method 
+		 * to set up the time and space discretization.
+		 * 
+		 * @param T Total time to maturity (in years).
+		 * @param r Market risk-free interest rate.
+		 * @param sigma Volatility of the underlying asset.
+		 * @param K Strike price of the option.
+		 * @param L Maximum asset price considered in the model.
+		 * @param M Number of time steps in the discretization.
+		 * @param N Number of asset price steps in the discretization.
+		 *
+		 * @throws std::invalid_argument If any parameter is negative, or if `M` or `N` is zero.
+		 */
+		Data(double T, double r, double sigma, double K, double L, double M, double N);
+
+		/**
+		 * @brief Constructs a copy of a Data object with other market parameters.
+		 *
+		 * The grid is shared with `d` when the rate is unchanged, the discount factors being
+		 * the only part of it depending on the market parameters.
+		 *
+		 * @param d A `Data` object containing the contract and the grid.
+		 * @param r Market risk-free interest rate.
+		 * @param sigma Volatility of the underlying asset.
+		 *
+		 * @throws std::invalid_argument If `r` is negative or if `sigma` is not positive.
+		 */
+		Data(const Data& d, double r, double sigma);
+
+		/**
+		 * @brief Gets the total time to maturity.
+		 * @return Total time to maturity (T).
+		 */
+		double get_T() const;
+
+		/**
+		 * @brief Gets the market risk-free interest rate.
+		 * @return Market risk-free interest rate (r).
+		 */
+		double get_r() const;
+
+		/**
+		 * @brief Gets the volatility of the underlying asset.
+		 * @return Volatility (sigma).
+		 */
+		double get_sigma() const;
+
+		/**
+		 * @brief Gets the strike price of the option.
+		 * @return Strike price (K).
+		 */
+		double get_K() const;
+
+		/**
+		 * @brief Gets the maximum asset price considered in the model.
+		 * @return Maximum asset price (L).
+		 */
+		double get_L() const;
+
+		/**
+		 * @brief Gets the number of time steps in the discretization.
+		 * @return Number of time steps (M).
+		 */
+		double get_M() const;
+
+		/**
+		 * @brief Gets the number of asset price steps in the discretization.
+		 * @return Number of asset price steps (N).
+		 */
+		double get_N() const;
+
+		/**
+		* @brief Gets the time step size.
+		* @return Time step size (dt).
+		*/
+		double get_dt() const;
+
+		/**
+		 * @brief Gets the asset price step size.
+		 * @return Asset price step size (ds).
+		 */
+		double get_ds() const;
+
+		/**
+		 * @brief Gets the discretized time vector.
+		 * @return A reference to the discretized time vector (t), valid as long as the object.
+		 */
+		const std::vector<double>& get_t() const;
+
+		/**
+		 * @brief Gets the discretized asset price vector.
+		 * @return A reference to the discretized asset price vector (l), valid as long as the object.
+		 */
+		const std::vector<double>& get_l() const;
+
+	};
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "evaluator.h"
+
+namespace ensiie
+{
+	Evaluator::Evaluator(double ds, const std::vector<double>& price) : ds_(ds), n_((int)price.size() - 1)
+	{
+		if (ds <= 0 || price.size() < 2)
+		{
+			throw std::invalid_argument("ds must be positive and at least two prices are required");
+		}
+
+		// Slopes of the intervals, in units of ds
+		std::vector<double> slope(n_);
+		for (int i = 0; i < n_; i++)
+		{
+			slope[i] = price[i + 1] - price[i];
+		}
+
+		// Derivatives at the nodes, harmonic means of the slopes (Fritsch-Carlson)
+		std::vector<double> m(n_ + 1);
+		m[0] = slope[0];
+		m[n_] = slope[n_ - 1];
+		for (int i = 1; i < n_; i++)
+		{
+			double product = slope[i - 1] * slope[i];
+			m[i] = (product > 0) ? 2 * product / (slope[i - 1] + slope[i]) : 0;
+		}
+
+		// Hermite cubics in the position t in [0, 1] of each interval
+		a_.resize(n_);
+		b_.resize(n_);
+		c_.resize(n_);
+		d_.resize(n_);
+		for (int i = 0; i < n_; i++)
+		{
+			a_[i] = price[i];
+			b_[i] = m[i];
+			c_[i] = 3 * slope[i] - 2 * m[i] - m[i + 1];
+			d_[i] = m[i] + m[i + 1] - 2 * slope[i];
+		}
+	}
+
+	double Evaluator::price(double s) const
+	{
+		double t;
+		int i = locate(s, t);
+		return a_[i] + t * (b_[i] + t * (c_[i] + t * d_[i]));
+	}
+
+	double Evaluator::delta(double s) const
+	{
+		double t;
+		int i = locate(s, t);
+		return (b_[i] + t * (2 * c_[i] + 3 * t * d_[i])) / ds_;
+	}
+
+	double Evaluator::gamma(double s) const
+	{
+		double t;
+		int i = locate(s, t);
+		return (2 * c_[i] + 6 * t * d_[i]) / (ds_ * ds_);
+	}
+
+	void Evaluator::price(const std::vector<double>& s, std::vector<double>& out) const
+	{
+		int n = (int)s.size();
+		out.resize(n);
+
+		for (int k = 0; k < n; k++)
+		{
+			double t;
+			int i = locate(s[k], t);
+			out[k] = a_[i] + t * (b_[i] + t * (c_[i] + t * d_[i]));
+		}
+	}
+
+	void Evaluator::delta(const std::vector<double>& s, std::vector<double>& out) const
+	{
+		int n = (int)s.size();
+		out.resize(n);
+
+		for (int k = 0; k < n; k++)
+		{
+			double t;
+			int i = locate(s[k], t);
+			out[k] = (b_[i] + t * (2 * c_[i] + 3 * t * d_[i])) / ds_;
+		}
+	}
+
+	void Evaluator::gamma(const std::vector<double>& s, std::vector<double>& out) const
+	{
+		int n = (int)s.size();
+		out.resize(n);
+
+		for (int k = 0; k < n; k++)
+		{
+			double t;
+			int i = locate(s[k], t);
+			out[k] = (2 * c_[i] + 6 * t * d_[i]) / (ds_ * ds_);
+		}
+	}
+}
\ No newline at end of file
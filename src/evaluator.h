@@ -0,0 +1,124 @@
+#pragma once
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+namespace ensiie
+{
+	/**
+	 * @class Evaluator
+	 * @brief A class to evaluate a solved price vector, its delta and its gamma at any spot price.
+	 *
+	 * @details
+	 * The prices on the uniform grid s_i = i ds are interpolated by a monotone cubic Hermite
+	 * spline: the derivatives at the nodes are the harmonic means of the adjacent slopes
+	 * (Fritsch-Carlson), 0 at a local extremum, so that no oscillation is created near the kink
+	 * of the payoff.
+	 *
+	 * The cubic of each interval is stored as four coefficients in separate vectors, computed
+	 * once at construction. The interval of a spot price is found in O(1) from the uniform
+	 * spacing, without search, so a batch query is a loop of a few loads and multiplications
+	 * per spot, the only branch being the range check. The spot prices outside [0, L] are rejected,
+	 * L being the last node of the grid, as by `Surface::price()`.
+	 */
+	class Evaluator
+	{
+		double ds_; /**< Asset price step of the grid.*/
+		int n_; /**< Number of intervals.*/
+		std::vector<double> a_; /**< Constant coefficients of the cubics.*/
+		std::vector<double> b_; /**< First order coefficients of the cubics.*/
+		std::vector<double> c_; /**< Second order coefficients of the cubics.*/
+		std::vector<double> d_; /**< Third order coefficients of the cubics.*/
+
+		/**
+		 * @brief Finds the interval of a spot price.
+		 *
+		 * A relative slack of 1e-12 is allowed above the last node, so that L itself, computed
+		 * by the caller as N ds with a rounding, is accepted.
+		 *
+		 * @param s Spot price.
+		 * @param t Position of the spot price in the interval, in units of ds.
+		 * @return The index of the interval.
+		 * @throws std::invalid_argument If the spot price is not in [0, L].
+		 */
+		int locate(double s, double& t) const
+		{
+			double x = s / ds_;
+			if (!(x >= 0 && x <= n_ * (1 + 1e-12)))
+			{
+				throw std::invalid_argument("The spot price must be in [0, L]");
+			}
+			int i = std::min((int)x, n_ - 1);
+			t = x - i;
+			return i;
+		}
+
+	public:
+
+		/**
+		 * @brief Constructs an Evaluator object from a price vector.
+		 *
+		 * @param ds Asset price step of the grid.
+		 * @param price Prices on the grid s_i = i ds.
+		 *
+		 * @throws std::invalid_argument If `ds` is not positive or if there are less than two prices.
+		 */
+		Evaluator(double ds, const std::vector<double>& price);
+
+		/**
+		 * @brief Constructs an Evaluator object from a solved engine.
+		 *
+		 * @param engine A `Complete` or `Reduced` engine whose `pricing()` has been called.
+		 */
+		template <typename Engine>
+		explicit Evaluator(const Engine& engine) : Evaluator(engine.get_ds(), engine.get_price()) {}
+
+		/**
+		 * @brief Computes the price at a spot price.
+		 * @param s Spot price.
+		 * @return The interpolated price.
+		 * @throws std::invalid_argument If `s` is not in [0, L].
+		 */
+		double price(double s) const;
+
+		/**
+		 * @brief Computes the delta at a spot price.
+		 * @param s Spot price.
+		 * @return The derivative of the interpolated price.
+		 * @throws std::invalid_argument If `s` is not in [0, L].
+		 */
+		double delta(double s) const;
+
+		/**
+		 * @brief Computes the gamma at a spot price.
+		 * @param s Spot price.
+		 * @return The second derivative of the interpolated price.
+		 * @throws std::invalid_argument If `s` is not in [0, L].
+		 */
+		double gamma(double s) const;
+
+		/**
+		 * @brief Computes the prices at a batch of spot prices.
+		 * @param s Spot prices.
+		 * @param out Vector overwritten with the prices, in the order of the spot prices.
+		 * @throws std::invalid_argument If a spot price is not in [0, L].
+		 */
+		void price(const std::vector<double>& s, std::vector<double>& out) const;
+
+		/**
+		 * @brief Computes the deltas at a batch of spot prices.
+		 * @param s Spot prices.
+		 * @param out Vector overwritten with the deltas, in the order of the spot prices.
+		 * @throws std::invalid_argument If a spot price is not in [0, L].
+		 */
+		void delta(const std::vector<double>& s, std::vector<double>& out) const;
+
+		/**
+		 * @brief Computes the gammas at a batch of spot prices.
+		 * @param s Spot prices.
+		 * @param out Vector overwritten with the gammas, in the order of the spot prices.
+		 * @throws std::invalid_argument If a spot price is not in [0, L].
+		 */
+		void gamma(const std::vector<double>& s, std::vector<double>& out) const;
+	};
+}
\ No newline at end of file
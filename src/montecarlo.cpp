@@ -0,0 +1,197 @@
+#include "montecarlo.h"
+
+namespace ensiie
+{
+	MonteCarlo::MonteCarlo(double T, double r, double sigma, double K, double L, double M, double N, double S0, long long paths, int steps, std::uint64_t seed)
+		: Data(T, r, sigma, K, L, M, N), S0_(S0), paths_(paths), steps_(steps), seed_(seed), threads_(0),
+		antithetic_(false), control_(false), control_price_(0), price_(0), std_error_(0), paths_per_second_(0)
+	{
+		check();
+	}
+
+	MonteCarlo::MonteCarlo(const Data& d, double S0, long long paths, int steps, std::uint64_t seed)
+		: Data(d), S0_(S0), paths_(paths), steps_(steps), seed_(seed), threads_(0),
+		antithetic_(false), control_(false), control_price_(0), price_(0), std_error_(0), paths_per_second_(0)
+	{
+		check();
+	}
+
+	void MonteCarlo::check() const
+	{
+		if (S0_ < 0 || paths_ <= 0 || steps_ <= 0)
+		{
+			throw std::invalid_argument("S0 must be non-negative, paths and steps must be positive");
+		}
+	}
+
+	double MonteCarlo::normal(std::uint64_t seed, std::uint64_t counter)
+	{
+		// Two uniforms obtained by hashing (seed, counter) with the splitmix64 finalizer
+		double u[2];
+		for (int k = 0; k < 2; k++)
+		{
+			std::uint64_t z = (2 * counter + k) * 0x9E3779B97F4A7C15ULL + seed;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			z = z ^ (z >> 31);
+			u[k] = ((z >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+		}
+
+		// Box-Muller transformation
+		return std::sqrt(-2 * std::log(u[0])) * std::cos(6.283185307179586 * u[1]);
+	}
+
+	void MonteCarlo::pricing()
+	{
+		double dt = T_ / steps_;
+		double drift = (r_ - 0.5 * sigma_ * sigma_) * dt;
+		double vol = sigma_ * std::sqrt(dt);
+		double discount = std::exp(-r_ * T_);
+
+		long long blocks = (paths_ + block_size - 1) / block_size;
+		unsigned int n_threads = threads_ ? threads_ : std::max(1u, std::thread::hardware_concurrency());
+
+		// Sums of Y, X, Y^2, X^2, XY and number of samples for each block
+		std::vector<double> moments(6 * blocks, 0);
+
+		auto start = std::chrono::steady_clock::now();
+
+		std::vector<std::thread> threads;
+		for (unsigned int p = 0; p < n_threads; p++)
+		{
+			threads.emplace_back([&, p]()
+			{
+				double s[block_size], sum[block_size], s_a[block_size], sum_a[block_size], z[block_size];
+
+				for (long long bk = p; bk < blocks; bk += n_threads)
+				{
+					long long first = bk * block_size;
+					int n = (int)std::min<long long>(block_size, paths_ - first);
+
+					for (int b = 0; b < n; b++)
+					{
+						s[b] = S0_;
+						s_a[b] = S0_;
+						sum[b] = 0;
+						sum_a[b] = 0;
+					}
+
+					// Exact simulation of the paths of the block, date after date
+					for (int m = 0; m < steps_; m++)
+					{
+						for (int b = 0; b < n; b++)
+						{
+							z[b] = normal(seed_, (std::uint64_t)(first + b) * steps_ + m);
+						}
+
+						for (int b = 0; b < n; b++)
+						{
+							s[b] *= std::exp(drift + vol * z[b]);
+							sum[b] += s[b];
+						}
+
+						if (antithetic_)
+						{
+							for (int b = 0; b < n; b++)
+							{
+								s_a[b] *= std::exp(drift - vol * z[b]);
+								sum_a[b] += s_a[b];
+							}
+						}
+					}
+
+					double* mom = &moments[6 * bk];
+					for (int b = 0; b < n; b++)
+					{
+						double y = discount * payoff(s[b], sum[b] / steps_);
+						double x = control_ ? discount * control_payoff(s[b]) : 0;
+
+						if (antithetic_)
+						{
+							y = 0.5 * (y + discount * payoff(s_a[b], sum_a[b] / steps_));
+							x = control_ ? 0.5 * (x + discount * control_payoff(s_a[b])) : 0;
+						}
+
+						mom[0] += y;
+						mom[1] += x;
+						mom[2] += y * y;
+						mom[3] += x * x;
+						mom[4] += x * y;
+						mom[5] += 1;
+					}
+				}
+			});
+		}
+
+		for (auto& th : threads)
+		{
+			th.join();
+		}
+
+		// Reduction in block order, independent from the number of threads
+		double sy = 0, sx = 0, syy = 0, sxx = 0, sxy = 0, n = 0;
+		for (long long bk = 0; bk < blocks; bk++)
+		{
+			sy += moments[6 * bk];
+			sx += moments[6 * bk + 1];
+			syy += moments[6 * bk + 2];
+			sxx += moments[6 * bk + 3];
+			sxy += moments[6 * bk + 4];
+			n += moments[6 * bk + 5];
+		}
+
+		double mean_y = sy / n;
+		double var_y = std::max(0.0, syy / n - mean_y * mean_y);
+
+		if (control_)
+		{
+			double mean_x = sx / n;
+			double var_x = sxx / n - mean_x * mean_x;
+			double cov = sxy / n - mean_x * mean_y;
+			double beta = var_x > 0 ? cov / var_x : 0;
+
+			price_ = mean_y - beta * (mean_x - control_price_);
+			var_y = std::max(0.0, var_y - beta * cov);
+		}
+		else
+		{
+			price_ = mean_y;
+		}
+
+		std_error_ = std::sqrt(var_y / n);
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		paths_per_second_ = (antithetic_ ? 2 : 1) * paths_ / seconds;
+	}
+
+	void MonteCarlo::set_threads(unsigned int threads)
+	{
+		threads_ = threads;
+	}
+
+	void MonteCarlo::set_antithetic(bool antithetic)
+	{
+		antithetic_ = antithetic;
+	}
+
+	void MonteCarlo::set_control(double price)
+	{
+		control_ = true;
+		control_price_ = price;
+	}
+
+	double MonteCarlo::get_price() const
+	{
+		return price_;
+	}
+
+	double MonteCarlo::get_std_error() const
+	{
+		return std_error_;
+	}
+
+	double MonteCarlo::get_paths_per_second() const
+	{
+		return paths_per_second_;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+#pragma once
+#include "data.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <chrono>
+
+namespace ensiie
+{
+	/**
+	 * @class MonteCarlo
+	 * @brief A base abstract class for pricing options by Monte Carlo simulation of the underlying asset.
+	 *
+	 * The `MonteCarlo` class extends the `Data` class and provides an engine independent from the
+	 * finite differences ones, used to validate them and to price path-dependent payoffs.
+	 *
+	 * @details
+	 * The underlying asset follows a geometric brownian motion, simulated exactly on `steps`
+	 * equally spaced dates. The paths are generated by blocks of `block_size` paths stored as
+	 * structure of arrays, so that the inner loops over the paths of a block can be vectorized.
+	 *
+	 * The normal variates come from a counter-based generator: the draw for the path p at the
+	 * date m is a pure function of (seed, p, m). The blocks are shared between threads and their
+	 * sums are reduced in block order, so the result does not depend on the number of threads.
+	 *
+	 * Two variance reduction techniques are available:
+	 * - antithetic variates, each path being paired with the one driven by the opposite draws;
+	 * - control variates, using a payoff of known price (given by a `Complete` engine or a closed
+	 *   form) with the regression coefficient estimated on the same paths.
+	 *
+	 * @note This class cannot be instantiated directly due to its abstract nature.
+	 */
+	class MonteCarlo : public Data
+	{
+	protected:
+		static const int block_size = 64; /**< Number of paths simulated together.*/
+
+		double S0_; /**< Spot price of the underlying asset.*/
+		long long paths_; /**< Number of simulated paths.*/
+		int steps_; /**< Number of simulated dates, equally spaced up to maturity.*/
+		std::uint64_t seed_; /**< Seed of the counter-based generator.*/
+		unsigned int threads_; /**< Number of threads, 0 for the number of hardware threads.*/
+		bool antithetic_; /**< Use of antithetic variates.*/
+		bool control_; /**< Use of the control variate.*/
+		double control_price_; /**< Known price of the control payoff.*/
+		double price_; /**< Estimated price of the option.*/
+		double std_error_; /**< Standard error of the estimated price.*/
+		double paths_per_second_; /**< Throughput of the last simulation.*/
+
+		/**
+		 * @brief Computes the payoff of the option on one path.
+		 *
+		 * @param s_T Underlying asset price at maturity.
+		 * @param average Arithmetic average of the underlying asset prices on the simulated dates.
+		 * @return The payoff of the option, not discounted.
+		 */
+		virtual double payoff(double s_T, double average) const = 0;
+
+		/**
+		 * @brief Computes the payoff used as control variate on one path.
+		 *
+		 * @param s_T Underlying asset price at maturity.
+		 * @return The payoff of the control, not discounted.
+		 */
+		virtual double control_payoff(double s_T) const = 0;
+
+		/**
+		 * @brief Checks the parameters of the simulation.
+		 *
+		 * @throws std::invalid_argument If `S0` is negative or if `paths` or `steps` is not positive.
+		 */
+		void check() const;
+
+	public:
+
+		/**
+		 * @brief Constructs a MonteCarlo object using financial parameters.
+		 *
+		 * @param T Time to maturity (in years)
+		 * @param r Market Risk-free interest rate
+		 * @param sigma Volatility of the underlying asset
+		 * @param K Strike price of the option
+		 * @param L Maximum value of the underlying asset
+		 * @param M Number of time steps
+		 * @param N Number of price steps
+		 * @param S0 Spot price of the underlying asset
+		 * @param paths Number of simulated paths
+		 * @param steps Number of simulated dates
+		 * @param seed Seed of the generator
+		 */
+		MonteCarlo(double T, double r, double sigma, double K, double L, double M, double N, double S0, long long paths, int steps, std::uint64_t seed = 0);
+
+		/**
+		 * @brief Constructs a MonteCarlo object using an existing Data object.
+		 *
+		 * @param d A `Data` object containing the financial parameters for the model
+		 * @param S0 Spot price of the underlying asset
+		 * @param paths Number of simulated paths
+		 * @param steps Number of simulated dates
+		 * @param seed Seed of the generator
+		 */
+		MonteCarlo(const Data& d, double S0, long long paths, int steps, std::uint64_t seed = 0);
+
+		/**
+		 * @brief Virtual destructor, the class being used polymorphically.
+		 */
+		virtual ~MonteCarlo() = default;
+
+		/**
+		 * @brief Simulates the paths and computes the price of the option at S0.
+		 */
+		void pricing();
+
+		/**
+		 * @brief Draws a standard normal variate from the counter-based generator.
+		 *
+		 * @param seed Seed of the generator.
+		 * @param counter Counter identifying the draw.
+		 * @return A standard normal variate.
+		 */
+		static double normal(std::uint64_t seed, std::uint64_t counter);
+
+		/**
+		 * @brief Sets the number of threads used by the simulation.
+		 * @param threads Number of threads, 0 for the number of hardware threads.
+		 */
+		void set_threads(unsigned int threads);
+
+		/**
+		 * @brief Enables or disables antithetic variates.
+		 * @param antithetic True to pair each path with its antithetic one.
+		 */
+		void set_antithetic(bool antithetic);
+
+		/**
+		 * @brief Enables the control variate.
+		 * @param price Known price at S0 of the control payoff, by a PDE engine or a closed form.
+		 */
+		void set_control(double price);
+
+		/**
+		 * @brief Gets the estimated price of the option at S0.
+		 * @return Estimated price.
+		 */
+		double get_price() const;
+
+		/**
+		 * @brief Gets the standard error of the estimated price.
+		 * @return Standard error.
+		 */
+		double get_std_error() const;
+
+		/**
+		 * @brief Gets the throughput of the last simulation.
+		 * @return Number of simulated paths per second.
+		 */
+		double get_paths_per_second() const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#include "montecarloasiancall.h"
+
+namespace ensiie
+{
+	MonteCarloAsianCall::MonteCarloAsianCall(double T, double r, double sigma, double K, double L, double M, double N, double S0, long long paths, int P, std::uint64_t seed) : MonteCarlo(T, r, sigma, K, L, M, N, S0, paths, P, seed) {};
+	MonteCarloAsianCall::MonteCarloAsianCall(const Data& d, double S0, long long paths, int P, std::uint64_t seed) : MonteCarlo(d, S0, paths, P, seed) {};
+
+	double MonteCarloAsianCall::payoff(double s_T, double average) const
+	{
+		(void)s_T;
+		return std::max(0.0, average - K_);
+	}
+
+	double MonteCarloAsianCall::control_payoff(double s_T) const
+	{
+		return std::max(0.0, s_T - K_);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include "montecarlo.h"
+
+namespace ensiie
+{
+	/**
+	* @class MonteCarloAsianCall
+	*
+	* @brief A class to calculate the price of a discretely monitored, fixed strike,
+	* arithmetic average-rate call option by Monte Carlo simulation.
+	*
+	* The fixing dates are equally spaced, t_k = k * T / P for k = 1, ..., P, as in `CompleteAsianCall`.
+	* The control variate is the European call option of same strike, whose price is given
+	* by `CompleteCall` or by the Black-Scholes formula.
+	*/
+	class MonteCarloAsianCall : public MonteCarlo
+	{
+		/**
+		 * @brief Computes the payoff of the asian call option on one path.
+		 *
+		 * @param s_T Underlying asset price at maturity.
+		 * @param average Arithmetic average of the underlying asset prices on the simulated dates.
+		 * @return The payoff of the option, not discounted.
+		 */
+		double payoff(double s_T, double average) const override;
+
+		/**
+		 * @brief Computes the payoff of the control variate, the European call option of same strike.
+		 *
+		 * @param s_T Underlying asset price at maturity.
+		 * @return The payoff of the control, not discounted.
+		 */
+		double control_payoff(double s_T) const override;
+
+	public:
+
+		/**
+		* @brief Constructs a MonteCarloAsianCall object using financial parameters.
+		*
+		* @param T Time to maturity (in years)
+		* @param r Market Risk-free interest rate
+		* @param sigma Volatility of the underlying asset
+		* @param K Strike price of the option
+		* @param L Maximum value of the underlying asset
+		* @param M Number of time steps
+		* @param N Number of price steps
+		* @param S0 Spot price of the underlying asset
+		* @param paths Number of simulated paths
+		* @param P Number of fixing dates
+		* @param seed Seed of the generator
+		*/
+		MonteCarloAsianCall(double T, double r, double sigma, double K, double L, double M, double N, double S0, long long paths, int P, std::uint64_t seed = 0);
+
+		/**
+		 * @brief Constructs a MonteCarloAsianCall object using an existing Data object.
+		 *
+		 * @param d A `Data` object containing the financial parameters for the model
+		 * @param S0 Spot price of the underlying asset
+		 * @param paths Number of simulated paths
+		 * @param P Number of fixing dates
+		 * @param seed Seed of the generator
+		 */
+		MonteCarloAsianCall(const Data& d, double S0, long long paths, int P, std::uint64_t seed = 0);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#include "montecarlocall.h"
+
+namespace ensiie
+{
+	MonteCarloCall::MonteCarloCall(double T, double r, double sigma, double K, double L, double M, double N, double S0, long long paths, std::uint64_t seed) : MonteCarlo(T, r, sigma, K, L, M, N, S0, paths, 1, seed) {};
+	MonteCarloCall::MonteCarloCall(const Data& d, double S0, long long paths, std::uint64_t seed) : MonteCarlo(d, S0, paths, 1, seed) {};
+
+	double MonteCarloCall::payoff(double s_T, double average) const
+	{
+		(void)average;
+		return std::max(0.0, s_T - K_);
+	}
+
+	double MonteCarloCall::control_payoff(double s_T) const
+	{
+		return s_T;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#include "montecarloput.h"
+
+namespace ensiie
+{
+	MonteCarloPut::MonteCarloPut(double T, double r, double sigma, double K, double L, double M, double N, double S0, long long paths, std::uint64_t seed) : MonteCarlo(T, r, sigma, K, L, M, N, S0, paths, 1, seed) {};
+	MonteCarloPut::MonteCarloPut(const Data& d, double S0, long long paths, std::uint64_t seed) : MonteCarlo(d, S0, paths, 1, seed) {};
+
+	double MonteCarloPut::payoff(double s_T, double average) const
+	{
+		(void)average;
+		return std::max(0.0, K_ - s_T);
+	}
+
+	double MonteCarloPut::control_payoff(double s_T) const
+	{
+		return s_T;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include "montecarlo.h"
+
+namespace ensiie
+{
+	/**
+	* @class MonteCarloPut
+	*
+	* @brief A class to calculate the price of a European put option by Monte Carlo simulation.
+	*
+	* The underlying asset is simulated directly at maturity. This engine is independent from the
+	* finite differences ones and is used to cross-validate `CompletePut` and `ReducedPut`.
+	* The control variate is the underlying asset itself, whose price is S0.
+	*/
+	class MonteCarloPut : public MonteCarlo
+	{
+		/**
+		 * @brief Computes the payoff of the put option on one path.
+		 *
+		 * @param s_T Underlying asset price at maturity.
+		 * @param average Arithmetic average of the underlying asset prices on the simulated dates.
+		 * @return The payoff of the option, not discounted.
+		 */
+		double payoff(double s_T, double average) const override;
+
+		/**
+		 * @brief Computes the payoff of the control variate, the underlying asset at maturity.
+		 *
+		 * @param s_T Underlying asset price at maturity.
+		 * @return The payoff of the control, not discounted.
+		 */
+		double control_payoff(double s_T) const override;
+
+	public:
+
+		/**
+		* @brief Constructs a MonteCarloPut object using financial parameters.
+		*
+		* @param T Time to maturity (in years)
+		* @param r Market Risk-free interest rate
+		* @param sigma Volatility of the underlying asset
+		* @param K Strike price of the option
+		* @param L Maximum value of the underlying asset
+		* @param M Number of time steps
+		* @param N Number of price steps
+		* @param S0 Spot price of the underlying asset
+		* @param paths Number of simulated paths
+		* @param seed Seed of the generator
+		*/
+		MonteCarloPut(double T, double r, double sigma, double K, double L, double M, double N, double S0, long long paths, std::uint64_t seed = 0);
+
+		/**
+		 * @brief Constructs a MonteCarloPut object using an existing Data object.
+		 *
+		 * @param d A `Data` object containing the financial parameters for the model
+		 * @param S0 Spot price of the underlying asset
+		 * @param paths Number of simulated paths
+		 * @param seed Seed of the generator
+		 */
+		MonteCarloPut(const Data& d, double S0, long long paths, std::uint64_t seed = 0);
+	};
+}
\ No newline at end of file
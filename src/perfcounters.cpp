@@ -0,0 +1,172 @@
+#include "perfcounters.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#define ENSIIE_PERF_EVENT
+#endif
+
+namespace ensiie
+{
+	static const int counters = (int)Counter::count;
+
+	PerfCounters::PerfCounters()
+	{
+		for (int k = 0; k < counters; k++)
+		{
+			fd_[k] = -1;
+			values_[k] = std::numeric_limits<double>::quiet_NaN();
+		}
+
+#ifdef ENSIIE_PERF_EVENT
+		static const std::uint64_t configs[counters] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+			PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+		for (int k = 0; k < counters; k++)
+		{
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = configs[k];
+			attr.disabled = 1;
+			attr.inherit = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+			fd_[k] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+			if (fd_[k] < 0 && error_.empty())
+			{
+				error_ = std::string("perf_event_open: ") + std::strerror(errno);
+			}
+		}
+#else
+		error_ = "hardware counters are only available on Linux";
+#endif
+	}
+
+	PerfCounters::~PerfCounters()
+	{
+#ifdef ENSIIE_PERF_EVENT
+		for (int k = 0; k < counters; k++)
+		{
+			if (fd_[k] >= 0)
+			{
+				close(fd_[k]);
+			}
+		}
+#endif
+	}
+
+	bool PerfCounters::available(Counter counter) const
+	{
+		return fd_[(int)counter] >= 0;
+	}
+
+	bool PerfCounters::available() const
+	{
+		for (int k = 0; k < counters; k++)
+		{
+			if (fd_[k] >= 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const std::string& PerfCounters::get_error() const
+	{
+		return error_;
+	}
+
+	void PerfCounters::start()
+	{
+#ifdef ENSIIE_PERF_EVENT
+		for (int k = 0; k < counters; k++)
+		{
+			if (fd_[k] >= 0)
+			{
+				ioctl(fd_[k], PERF_EVENT_IOC_RESET, 0);
+			}
+		}
+		for (int k = 0; k < counters; k++)
+		{
+			if (fd_[k] >= 0)
+			{
+				ioctl(fd_[k], PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+#endif
+	}
+
+	void PerfCounters::stop()
+	{
+#ifdef ENSIIE_PERF_EVENT
+		for (int k = 0; k < counters; k++)
+		{
+			if (fd_[k] >= 0)
+			{
+				ioctl(fd_[k], PERF_EVENT_IOC_DISABLE, 0);
+			}
+		}
+
+		// Value, time enabled and time running, the value being scaled when multiplexed
+		for (int k = 0; k < counters; k++)
+		{
+			values_[k] = std::numeric_limits<double>::quiet_NaN();
+			std::uint64_t data[3];
+			if (fd_[k] >= 0 && read(fd_[k], data, sizeof(data)) == (ssize_t)sizeof(data))
+			{
+				values_[k] = (data[2] > 0) ? (double)data[0] * ((double)data[1] / data[2]) : 0;
+			}
+		}
+#endif
+	}
+
+	double PerfCounters::get(Counter counter) const
+	{
+		return values_[(int)counter];
+	}
+
+	double PerfCounters::get_ipc() const
+	{
+		double cycles = get(Counter::cycles);
+		return cycles > 0 ? get(Counter::instructions) / cycles : std::numeric_limits<double>::quiet_NaN();
+	}
+
+	/**
+	 * @brief Formats a value, "n/a" if it is NaN.
+	 */
+	static std::string format(const char* format, double value)
+	{
+		if (std::isnan(value))
+		{
+			return "n/a";
+		}
+		char text[64];
+		std::snprintf(text, sizeof(text), format, value);
+		return text;
+	}
+
+	std::string PerfCounters::report(const std::string& label, double nodes) const
+	{
+		char line[256];
+		std::snprintf(line, sizeof(line), "%-24s %16s %8s %14s %14s %14s", label.c_str(),
+			format("%.0f", get(Counter::cycles)).c_str(),
+			format("%.2f", get_ipc()).c_str(),
+			format("%.3f", get(Counter::cycles) / nodes).c_str(),
+			format("%.5f", get(Counter::cache_misses) / nodes).c_str(),
+			format("%.5f", get(Counter::branch_misses) / nodes).c_str());
+		return line;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+#include <string>
+
+namespace ensiie
+{
+	/**
+	 * @brief Hardware events read by `PerfCounters`.
+	 */
+	enum class Counter : int
+	{
+		cycles, /**< CPU cycles.*/
+		instructions, /**< Retired instructions.*/
+		cache_misses, /**< Last-level cache misses.*/
+		branch_misses, /**< Mispredicted branches.*/
+		count /**< Number of events.*/
+	};
+
+	/**
+	 * @class PerfCounters
+	 * @brief Hardware performance counters of the calling thread, read with `perf_event_open()`.
+	 *
+	 * @details
+	 * The counters measure the code run between `start()` and `stop()`, in user space, for
+	 * the calling thread and the threads it creates meanwhile, such as the threads of the
+	 * parallel tridiagonal solve. The ratios tell whether the sweeps are bound by the memory,
+	 * many cache misses per node, or by the latency of their recurrences, a low number of
+	 * instructions per cycle without misses.
+	 *
+	 * Each event is opened on its own, so that an event missing from the processor or from
+	 * a virtual machine does not disable the others. When the kernel refuses the counters,
+	 * typically with `perf_event_paranoid` above 2 or in a container, or on the systems other
+	 * than Linux, the events are unavailable, their values are NaN, and `get_error()` tells why.
+	 * When the events are multiplexed, the values are scaled by the fraction of time counted.
+	 */
+	class PerfCounters
+	{
+		int fd_[(int)Counter::count]; /**< File descriptors of the events, -1 if unavailable.*/
+		double values_[(int)Counter::count]; /**< Values measured by the last `stop()`.*/
+		std::string error_; /**< Reason of the first event that could not be opened.*/
+
+	public:
+
+		/**
+		 * @brief Opens the counters, disabled.
+		 */
+		PerfCounters();
+
+		/**
+		 * @brief Closes the counters.
+		 */
+		~PerfCounters();
+
+		PerfCounters(const PerfCounters&) = delete;
+		PerfCounters& operator=(const PerfCounters&) = delete;
+
+		/**
+		 * @brief Tells whether an event is counted.
+		 * @param counter Event.
+		 * @return True if the event could be opened.
+		 */
+		bool available(Counter counter) const;
+
+		/**
+		 * @brief Tells whether at least one event is counted.
+		 * @return True if an event could be opened.
+		 */
+		bool available() const;
+
+		/**
+		 * @brief Gets the reason why an event could not be opened.
+		 * @return The error message, empty if all the events are available.
+		 */
+		const std::string& get_error() const;
+
+		/**
+		 * @brief Resets and enables the counters.
+		 */
+		void start();
+
+		/**
+		 * @brief Disables the counters and reads their values.
+		 */
+		void stop();
+
+		/**
+		 * @brief Gets the value of an event measured by the last `stop()`.
+		 * @param counter Event.
+		 * @return The count, NaN if the event is unavailable.
+		 */
+		double get(Counter counter) const;
+
+		/**
+		 * @brief Gets the instructions per cycle measured by the last `stop()`.
+		 * @return The ratio, NaN if an event is unavailable.
+		 */
+		double get_ipc() const;
+
+		/**
+		 * @brief Formats the measures of the last `stop()` per grid node.
+		 *
+		 * @param label Label of the line.
+		 * @param nodes Number of grid nodes processed, N+1 for a setup and (N+1) M for a sweep.
+		 * @return A line with the cycles, the instructions per cycle, and the cycles, cache misses
+		 * and branch misses per node, "n/a" standing for the unavailable events.
+		 */
+		std::string report(const std::string& label, double nodes) const;
+	};
+}
\ No newline at end of file
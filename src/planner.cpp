@@ -0,0 +1,186 @@
+#include "planner.h"
+
+namespace ensiie
+{
+	Planner::Planner(double T, double r, double sigma, double K, double S0, bool call, double price_tol, double delta_tol)
+	{
+		// Excpetion for negative values
+		if (T < 0 || r < 0 || sigma < 0 || K < 0 || S0 < 0 || price_tol < 0 || delta_tol < 0)
+		{
+			throw std::invalid_argument("Values must be non-negative");
+		}
+		// Exception for null parameters
+		else if (sigma == 0 || K == 0 || S0 == 0 || price_tol == 0)
+		{
+			throw std::invalid_argument("sigma, K, S0 and the price tolerance must be positive");
+		}
+
+		T_ = T;
+		r_ = r;
+		sigma_ = sigma;
+		K_ = K;
+		S0_ = S0;
+		call_ = call;
+		price_tol_ = price_tol;
+		delta_tol_ = delta_tol;
+
+		domain_sizing();
+		grid_selection();
+	}
+
+	void Planner::domain_sizing()
+	{
+		double deviation = sigma_ * std::sqrt(T_);
+		double level = std::max(S0_, K_);
+		double n = 3;
+
+		// Smallest n for which L * P(S_T > L) is below the tolerance
+		L_ = level * std::exp(r_ * T_ + n * deviation);
+		while (L_ * 0.5 * std::erfc(n / std::sqrt(2.0)) > 0.1 * price_tol_)
+		{
+			n += 0.25;
+			L_ = level * std::exp(r_ * T_ + n * deviation);
+		}
+	}
+
+	void Planner::pilot(double M, double N, double& price, double& delta) const
+	{
+		Data d(T_, r_, sigma_, K_, L_, M, N);
+		std::vector<double> v;
+
+		if (call_)
+		{
+			CompleteCall c(d);
+			c.pricing();
+			v = c.get_price();
+		}
+		else
+		{
+			CompletePut p(d);
+			p.pricing();
+			v = p.get_price();
+		}
+
+		// Linear interpolation of the price and of the centered delta at S0
+		double ds = d.get_ds();
+		double x = S0_ / ds;
+		int j = std::max(1, std::min((int)x, (int)N - 2));
+		double w = x - j;
+
+		price = (1 - w) * v[j] + w * v[j + 1];
+		delta = (1 - w) * (v[j + 1] - v[j - 1]) / (2 * ds) + w * (v[j + 2] - v[j]) / (2 * ds);
+	}
+
+	void Planner::grid_selection()
+	{
+		double p, d, p_s, d_s, p_t, d_t;
+
+		// Pilot grid with a few nodes between 0 and S0 so that the errors are in the asymptotic regime
+		double n0 = std::max((double)N0, std::ceil(8 * L_ / std::min(S0_, K_)));
+
+		pilot(M0, n0, p, d);
+		pilot(M0, 2 * n0, p_s, d_s);
+		pilot(2 * M0, n0, p_t, d_t);
+
+		// Richardson estimates of the errors of the pilot grid, the scheme being of second order
+		double e_s = std::fabs(p - p_s) * 4 / 3;
+		double e_t = std::fabs(p - p_t) * 4 / 3;
+
+		// Smallest numbers of steps giving a quarter of the tolerance to each term
+		double n_ratio = std::sqrt(e_s / (0.25 * price_tol_));
+		double m_ratio = std::sqrt(e_t / (0.25 * price_tol_));
+
+		if (delta_tol_ > 0)
+		{
+			n_ratio = std::max(n_ratio, std::sqrt(std::fabs(d - d_s) * 4 / 3 / (0.25 * delta_tol_)));
+			m_ratio = std::max(m_ratio, std::sqrt(std::fabs(d - d_t) * 4 / 3 / (0.25 * delta_tol_)));
+		}
+
+		// Grid fine enough to resolve S0 and the strike, with even numbers of steps for the check
+		N_ = even(std::max(std::ceil(n0 * n_ratio), std::ceil(4 * L_ / std::min(S0_, K_))));
+		M_ = even(std::max(std::ceil(M0 * m_ratio), (double)M_min));
+		M_ = even(damped_steps(M_, N_));
+
+		// A posteriori check by successive refinements. On a miss, the number of steps whose term
+		// of the model is the larger is doubled, the term being divided by four
+		double time_term = (M0 * m_ratio / M_) * (M0 * m_ratio / M_);
+		double space_term = (n0 * n_ratio / N_) * (n0 * n_ratio / N_);
+		error_ = error(M_, N_);
+		for (int k = 0; k < max_refinements && error_ > 1; k++)
+		{
+			if (time_term >= space_term)
+			{
+				M_ *= 2;
+				time_term /= 4;
+			}
+			else
+			{
+				N_ *= 2;
+				space_term /= 4;
+				M_ = even(damped_steps(M_, N_));
+			}
+			error_ = error(M_, N_);
+		}
+	}
+
+	double Planner::damped_steps(double M, double N) const
+	{
+		// Crank-Nicolson multiplies the highest mode at the strike by (lambda - 1) / (lambda + 1) per step
+		double ds = L_ / N;
+		while (true)
+		{
+			double lambda = sigma_ * sigma_ * K_ * K_ * (T_ / M) / (ds * ds);
+			double damping = std::pow(std::fabs((lambda - 1) / (lambda + 1)), M);
+			if (damping * ds <= 0.25 * price_tol_)
+			{
+				return M;
+			}
+			M = std::ceil(1.25 * M);
+		}
+	}
+
+	double Planner::even(double n)
+	{
+		return 2 * std::ceil(0.5 * n);
+	}
+
+	double Planner::error(double M, double N) const
+	{
+		double p_half, d_half, p, d;
+		pilot(0.5 * M, 0.5 * N, p_half, d_half);
+		pilot(M, N, p, d);
+
+		// For a scheme of order q, the error of the grid is the difference with the half grid over 2^q - 1
+		double e = std::fabs(p - p_half) / price_tol_;
+		if (delta_tol_ > 0)
+		{
+			e = std::max(e, std::fabs(d - d_half) / delta_tol_);
+		}
+		return e;
+	}
+
+	Data Planner::plan() const
+	{
+		return Data(T_, r_, sigma_, K_, L_, M_, N_);
+	}
+
+	double Planner::get_L() const
+	{
+		return L_;
+	}
+
+	double Planner::get_M() const
+	{
+		return M_;
+	}
+
+	double Planner::get_N() const
+	{
+		return N_;
+	}
+
+	double Planner::get_error() const
+	{
+		return error_;
+	}
+}
\ No newline at end of file
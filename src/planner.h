@@ -0,0 +1,158 @@
+#pragma once
+#include "completecall.h"
+#include "completeput.h"
+
+namespace ensiie
+{
+	/**
+	 * @class Planner
+	 * @brief A class to choose the domain and the grid of the `Complete` engines from a target accuracy.
+	 *
+	 * @details
+	 * The maximum asset price is taken as L = max(S0, K) * e^(rT + n sigma sqrt(T)), where the
+	 * number n of standard deviations is the smallest one for which the probability of ending
+	 * above L, multiplied by L, is below the price tolerance.
+	 *
+	 * The number of steps is then chosen with an error model calibrated on small pilot solves.
+	 * The error of the Crank-Nicolson scheme being e = C_s ds^2 + C_t dt^2, the constants are
+	 * estimated by Richardson extrapolation from solves on (N0, M0), (2 N0, M0) and (N0, 2 M0)
+	 * steps, N0 giving at least eight nodes between 0 and S0, both for the price and the delta
+	 * at S0. A quarter of the tolerance is given to each term, the factor two of safety covering
+	 * the non-smooth payoff, and N and M are the smallest numbers of steps meeting it.
+	 *
+	 * The Crank-Nicolson steps do not damp the kink of the payoff, whose oscillations are not
+	 * of second order and grow with dt / ds^2, so that the pilots alone can underestimate the
+	 * error by orders of magnitude. The number of time steps is therefore raised until these
+	 * oscillations are damped below the tolerance, see `damped_steps()`.
+	 *
+	 * The chosen grid is then checked a posteriori by successive refinements, without any
+	 * closed form, so that the check holds for any payoff of the engines: the grid with half
+	 * the steps is solved, and for a scheme of order at least one its difference with the
+	 * chosen grid bounds the error of the chosen grid. While it misses the tolerance, the number
+	 * of steps with the larger term of the model is doubled, at most `max_refinements` times.
+	 * The check solves the chosen grid and the half grid, so the checks of the successive grids
+	 * cost at most 2.5 solves of the final grid, and the pilots a small fixed amount.
+	 */
+	class Planner
+	{
+		double T_; /**< Time to maturity.*/
+		double r_; /**< Market risk-free interest rate.*/
+		double sigma_; /**< Underlying asset volatility.*/
+		double K_; /**< Strike price of the option.*/
+		double S0_; /**< Spot price at which the accuracy is required.*/
+		bool call_; /**< True for a call option, false for a put option.*/
+		double price_tol_; /**< Tolerance on the price at S0.*/
+		double delta_tol_; /**< Tolerance on the delta at S0, 0 if not required.*/
+		double L_; /**< Chosen maximum asset price.*/
+		double M_; /**< Chosen number of time steps.*/
+		double N_; /**< Chosen number of asset price steps.*/
+
+		double error_; /**< Error of the chosen grid at S0, relative to the tolerances.*/
+
+		static const int N0 = 64; /**< Minimum number of asset price steps of the pilot solves.*/
+		static const int M0 = 64; /**< Number of time steps of the pilot solves.*/
+		static const int M_min = 16; /**< Minimum number of time steps of the chosen grid.*/
+		static const int max_refinements = 4; /**< Maximum number of doublings of the a posteriori check.*/
+
+		/**
+		 * @brief Computes the maximum asset price from the price tolerance.
+		 */
+		void domain_sizing();
+
+		/**
+		 * @brief Solves a pilot problem and interpolates the price and the delta at S0.
+		 *
+		 * @param M Number of time steps.
+		 * @param N Number of asset price steps.
+		 * @param price Interpolated price at S0.
+		 * @param delta Interpolated delta at S0.
+		 */
+		void pilot(double M, double N, double& price, double& delta) const;
+
+		/**
+		 * @brief Estimates the error at S0 of a grid by comparison with the grid of half the steps.
+		 *
+		 * @param M Number of time steps, even.
+		 * @param N Number of asset price steps, even.
+		 * @return The larger of the price difference over the price tolerance and, if required,
+		 * of the delta difference over the delta tolerance, so that the grid meets the
+		 * tolerances for at most 1.
+		 */
+		double error(double M, double N) const;
+
+		/**
+		 * @brief Rounds a number of steps up to an even number.
+		 * @param n Number of steps.
+		 * @return The smallest even number not below n.
+		 */
+		static double even(double n);
+
+		/**
+		 * @brief Computes the number of time steps damping the oscillations of the kink.
+		 *
+		 * Each Crank-Nicolson step multiplies the highest mode of the grid at the strike by
+		 * (lambda - 1) / (lambda + 1), with lambda = sigma^2 K^2 dt / ds^2. The number of time steps
+		 * is raised by a quarter until this mode, of amplitude ds at the kink, is damped below a
+		 * quarter of the price tolerance.
+		 *
+		 * @param M Number of time steps of the model.
+		 * @param N Number of asset price steps.
+		 * @return The number of time steps, at least M.
+		 */
+		double damped_steps(double M, double N) const;
+
+		/**
+		 * @brief Calibrates the error model and chooses the numbers of steps.
+		 */
+		void grid_selection();
+
+	public:
+
+		/**
+		 * @brief Constructs a Planner object and chooses the domain and the grid.
+		 *
+		 * @param T Time to maturity (in years)
+		 * @param r Market Risk-free interest rate
+		 * @param sigma Volatility of the underlying asset
+		 * @param K Strike price of the option
+		 * @param S0 Spot price at which the accuracy is required
+		 * @param call True for a call option, false for a put option
+		 * @param price_tol Tolerance on the price at S0
+		 * @param delta_tol Tolerance on the delta at S0, 0 if not required
+		 *
+		 * @throws std::invalid_argument If a parameter is negative, or if `sigma`, `K`, `S0`
+		 * or `price_tol` is zero.
+		 */
+		Planner(double T, double r, double sigma, double K, double S0, bool call, double price_tol, double delta_tol = 0);
+
+		/**
+		 * @brief Builds the `Data` object of the chosen grid.
+		 * @return A `Data` object with the chosen L, M and N.
+		 */
+		Data plan() const;
+
+		/**
+		 * @brief Gets the chosen maximum asset price.
+		 * @return Maximum asset price (L).
+		 */
+		double get_L() const;
+
+		/**
+		 * @brief Gets the chosen number of time steps.
+		 * @return Number of time steps (M).
+		 */
+		double get_M() const;
+
+		/**
+		 * @brief Gets the chosen number of asset price steps.
+		 * @return Number of asset price steps (N).
+		 */
+		double get_N() const;
+
+		/**
+		 * @brief Gets the estimated error at S0 of the chosen grid, relative to the tolerances.
+		 * @return The estimated error over the tolerance, at most 1 unless the refinements were exhausted.
+		 */
+		double get_error() const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "profile.h"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ensiie
+{
+	static const int phases = (int)Phase::count;
+
+	/**
+	 * @brief Measures of a thread, written by the thread only and read by the report.
+	 */
+	struct ProfileTable
+	{
+		std::atomic<long long> calls[phases];
+		std::atomic<long long> nanoseconds[phases];
+		std::atomic<long long> items[phases];
+		bool in_use; /**< True while a thread writes in the table, under the registry lock.*/
+
+		ProfileTable() : in_use(false)
+		{
+			for (int p = 0; p < phases; p++)
+			{
+				calls[p] = 0;
+				nanoseconds[p] = 0;
+				items[p] = 0;
+			}
+		}
+	};
+
+	/**
+	 * @brief Tables of all the threads, never freed so that the threads may end after the program.
+	 */
+	struct ProfileRegistry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ProfileTable>> tables;
+	};
+
+	static ProfileRegistry& registry()
+	{
+		static ProfileRegistry* r = new ProfileRegistry();
+		return *r;
+	}
+
+	/**
+	 * @brief Table held by a thread during its lifetime.
+	 */
+	struct ProfileSlot
+	{
+		ProfileTable* table;
+
+		ProfileSlot() : table(nullptr)
+		{
+			ProfileRegistry& r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			for (auto& t : r.tables)
+			{
+				if (!t->in_use)
+				{
+					table = t.get();
+					break;
+				}
+			}
+			if (!table)
+			{
+				r.tables.push_back(std::make_unique<ProfileTable>());
+				table = r.tables.back().get();
+			}
+			table->in_use = true;
+		}
+
+		~ProfileSlot()
+		{
+			std::lock_guard<std::mutex> lock(registry().mutex);
+			table->in_use = false;
+		}
+	};
+
+	bool Profiler::enabled()
+	{
+#ifdef ENSIIE_PROFILE
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void Profiler::add(Phase phase, long long nanoseconds, long long items)
+	{
+		thread_local ProfileSlot slot;
+		ProfileTable& t = *slot.table;
+		int p = (int)phase;
+
+		// Single writer, so plain loads and stores without read-modify-write
+		t.calls[p].store(t.calls[p].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		t.nanoseconds[p].store(t.nanoseconds[p].load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+		t.items[p].store(t.items[p].load(std::memory_order_relaxed) + items, std::memory_order_relaxed);
+	}
+
+	const char* Profiler::name(Phase phase)
+	{
+		static const char* names[phases] = { "discretize", "coefficients_computation", "lu_factorization", "t_transformation",
+			"l_transformation", "boundaries", "forward_sweep", "back_substitution", "price_transformation", "extraction" };
+		return names[(int)phase];
+	}
+
+	/**
+	 * @brief Appends the lines of the phases with at least one call.
+	 */
+	static void report_lines(std::string& out, const char* label, const long long* calls, const long long* nanoseconds, const long long* items)
+	{
+		char line[256];
+		for (int p = 0; p < phases; p++)
+		{
+			if (calls[p] == 0)
+			{
+				continue;
+			}
+			double ms = nanoseconds[p] * 1e-6;
+			double per_item = items[p] > 0 ? (double)nanoseconds[p] / items[p] : 0;
+			std::snprintf(line, sizeof(line), "%-8s %-26s %12lld %12.3f %12.3f %14lld %10.3f\n", label, Profiler::name((Phase)p),
+				calls[p], ms, 1e3 * ms / calls[p], items[p], per_item);
+			out += line;
+		}
+	}
+
+	std::string Profiler::report(bool per_thread)
+	{
+		if (!enabled())
+		{
+			return "Profiling disabled, build with -DENSIIE_PROFILE\n";
+		}
+
+		ProfileRegistry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+
+		std::string out;
+		char line[256];
+		std::snprintf(line, sizeof(line), "%-8s %-26s %12s %12s %12s %14s %10s\n", "thread", "phase", "calls", "total ms", "mean us", "items", "ns/item");
+		out += line;
+
+		long long calls[phases] = {}, nanoseconds[phases] = {}, items[phases] = {};
+		std::vector<std::vector<long long>> tables;
+		for (auto& t : r.tables)
+		{
+			std::vector<long long> values(3 * phases);
+			for (int p = 0; p < phases; p++)
+			{
+				values[p] = t->calls[p].load(std::memory_order_relaxed);
+				values[phases + p] = t->nanoseconds[p].load(std::memory_order_relaxed);
+				values[2 * phases + p] = t->items[p].load(std::memory_order_relaxed);
+				calls[p] += values[p];
+				nanoseconds[p] += values[phases + p];
+				items[p] += values[2 * phases + p];
+			}
+			tables.push_back(std::move(values));
+		}
+
+		report_lines(out, "all", calls, nanoseconds, items);
+		if (per_thread)
+		{
+			for (std::size_t k = 0; k < tables.size(); k++)
+			{
+				std::string label = std::to_string(k);
+				report_lines(out, label.c_str(), tables[k].data(), tables[k].data() + phases, tables[k].data() + 2 * phases);
+			}
+		}
+		return out;
+	}
+
+	void Profiler::reset()
+	{
+		ProfileRegistry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		for (auto& t : r.tables)
+		{
+			for (int p = 0; p < phases; p++)
+			{
+				t->calls[p] = 0;
+				t->nanoseconds[p] = 0;
+				t->items[p] = 0;
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+namespace ensiie
+{
+	/**
+	 * @brief Phases of the engines measured by the `Profiler`.
+	 */
+	enum class Phase : int
+	{
+		discretize, /**< Construction of the grid, `Data::discretize()`.*/
+		coefficients_computation, /**< Coefficients of the scheme.*/
+		lu_factorization, /**< LU factorization of the system of a step.*/
+		t_transformation, /**< Change of variable in time.*/
+		l_transformation, /**< Change of variable in space.*/
+		boundaries, /**< Terminal condition and boundary conditions of the steps.*/
+		forward_sweep, /**< Right-hand side and forward substitution of a step.*/
+		back_substitution, /**< Back substitution of a step.*/
+		price_transformation, /**< Change of the modified prices back to prices.*/
+		extraction, /**< Interpolation of the quotes from a solved layer.*/
+		count /**< Number of phases.*/
+	};
+
+	/**
+	 * @class Profiler
+	 * @brief Timers and counters of the phases of the engines.
+	 *
+	 * @details
+	 * The phases are measured with `ENSIIE_PROFILE_SCOPE(phase, items)`, which times the rest
+	 * of the enclosing block and counts one call and `items` processed items, typically the
+	 * rows of a sweep. The instrumentation is compiled only with `-DENSIIE_PROFILE`: without
+	 * it the macro expands to nothing, so that the engines carry no cost at all.
+	 *
+	 * Each thread accumulates in its own table, without locking nor shared cache lines, the
+	 * table of a finished thread being reused by the next one. `report()` sums the tables.
+	 */
+	class Profiler
+	{
+	public:
+
+		/**
+		 * @class Scope
+		 * @brief Timer of a phase, from its construction to its destruction.
+		 */
+		class Scope
+		{
+			Phase phase_; /**< Measured phase.*/
+			long long items_; /**< Number of items processed.*/
+			std::chrono::steady_clock::time_point start_; /**< Start of the measure.*/
+
+		public:
+
+			/**
+			 * @brief Starts the timer.
+			 * @param phase Measured phase.
+			 * @param items Number of items processed.
+			 */
+			Scope(Phase phase, long long items) : phase_(phase), items_(items), start_(std::chrono::steady_clock::now()) {};
+
+			/**
+			 * @brief Stops the timer and adds the measure to the table of the thread.
+			 */
+			~Scope()
+			{
+				add(phase_, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count(), items_);
+			}
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		};
+
+		/**
+		 * @brief Tells whether the instrumentation is compiled.
+		 * @return True if built with `ENSIIE_PROFILE`.
+		 */
+		static bool enabled();
+
+		/**
+		 * @brief Adds a measure to the table of the calling thread.
+		 *
+		 * @param phase Measured phase.
+		 * @param nanoseconds Duration of the call.
+		 * @param items Number of items processed.
+		 */
+		static void add(Phase phase, long long nanoseconds, long long items);
+
+		/**
+		 * @brief Gets the name of a phase.
+		 * @param phase Phase.
+		 * @return The name, as in the code.
+		 */
+		static const char* name(Phase phase);
+
+		/**
+		 * @brief Formats the measures, as one line per phase with its calls, total and mean
+		 * times, and items.
+		 *
+		 * @param per_thread True to add the lines of each thread table after the totals.
+		 * @return The report.
+		 */
+		static std::string report(bool per_thread = false);
+
+		/**
+		 * @brief Clears the measures, while no instrumented code runs.
+		 */
+		static void reset();
+	};
+}
+
+#ifdef ENSIIE_PROFILE
+#define ENSIIE_PROFILE_CONCAT_(a, b) a##b
+#define ENSIIE_PROFILE_CONCAT(a, b) ENSIIE_PROFILE_CONCAT_(a, b)
+#define ENSIIE_PROFILE_SCOPE(phase, items) ensiie::Profiler::Scope ENSIIE_PROFILE_CONCAT(profile_scope_, __LINE__)(ensiie::Phase::phase, (long long)(items))
+#else
+#define ENSIIE_PROFILE_SCOPE(phase, items) ((void)0)
+#endif
\ No newline at end of file
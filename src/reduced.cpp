@@ -1,53 +1,383 @@
-#include "reduced.h"
-
-namespace ensiie
-{
-	Reduced::Reduced(double T, double r, double sigma, double K, double L, double M, double N) : Change(T, r, sigma, K, L, M, N) 
-	{
-		theta_ = dt_changed_ / (2 * ds_changed_ * ds_changed_);
-		lu_factorization();
-	};
-
-	Reduced::Reduced(const Data& d) : Change(d) 
-	{
-		theta_ = dt_changed_ / (2 * ds_changed_ * ds_changed_);
-		lu_factorization();
-	};
-
-	void Reduced::lu_factorization()
-	{
-		std::vector<double> low(N_ + 1, 0), up(N_ + 1, 0);
-
-		for (int i = 0; i <= N_; i++)
-		{
-			if (i == 0)
-			{
-				up[i] = 1 + 2 * theta_;
-				low[i] = 0;
-			}
-			else
-			{
-				low[i] = -theta_ / up[i - 1];
-				up[i] = (1 + 2 * theta_) + low[i] * theta_;
-			}
-		}
-
-		low_ = low;
-		up_ = up;
-	}
-
-	double Reduced::get_theta() const
-	{
-		return theta_;
-	}
-
-	std::vector<double> Reduced::get_low() const
-	{
-		return low_;
-	}
-
-	std::vector<double> Reduced::get_up() const
-	{
-		return up_;
-	}
+#include "reduced.h"
+#include "profile.h"
+#include "trace.h"
+
+namespace ensiie
+{
+	Reduced::Reduced(double T, double r, double sigma, double K, double L, double M, double N) : Change(T, r, sigma, K, L, M, N), scheme_theta_(1), tolerance_(0), steps_(0), surface_(nullptr), checkpoint_(nullptr)
+	{
+		theta_ = dt_changed_ / (ds_changed_ * ds_changed_);
+		lu_factorization();
+	};
+
+	Reduced::Reduced(const Data& d) : Change(d), scheme_theta_(1), tolerance_(0), steps_(0), surface_(nullptr), checkpoint_(nullptr)
+	{
+		theta_ = dt_changed_ / (ds_changed_ * ds_changed_);
+		lu_factorization();
+	};
+
+	void Reduced::lu_factorization()
+	{
+		factorization(scheme_theta_ * theta_, low_, up_);
+	}
+
+	void Reduced::factorization(double theta, std::vector<double>& low, std::vector<double>& up) const
+	{
+		ENSIIE_PROFILE_SCOPE(lu_factorization, N_ + 1);
+		double eps = std::numeric_limits<double>::epsilon();
+
+		low.assign(1, 0);
+		up.assign(1, 1 + 2 * theta);
+
+		/// Rows are added until the factors stop changing, the last one being the limit.
+		/// The remaining changes sum to at most d ratio / (1 - ratio), d being the last one
+		for (int i = 1; i <= N_; i++)
+		{
+			low.push_back(-theta / up[i - 1]);
+			up.push_back((1 + 2 * theta) + low[i] * theta);
+
+			double ratio = (theta / up[i]) * (theta / up[i]);
+			if (std::fabs(up[i] - up[i - 1]) * ratio <= eps * up[i] * (1 - ratio))
+			{
+				break;
+			}
+		}
+	}
+
+	void Reduced::theta_step(std::vector<double>& v, double theta, double w, const std::vector<double>& low, const std::vector<double>& up,
+		double lower, double upper, std::vector<double>& y) const
+	{
+		double e = (1 - w) * theta;
+		double c = 1 - 2 * e;
+		double a = w * theta;
+
+		/// The unknowns are the nodes 1 to N-1, the node j using the row j-1 of the factors.
+		/// Rows from p on use the limit values of the factors, p being at most N
+		int p = (int)up.size() - 1;
+		double low_limit = low[p];
+		double inv_limit = 1 / up[p];
+
+		/// Solution to the problem Ly=b, b being the explicit part computed on the fly
+		{
+			ENSIIE_PROFILE_SCOPE(forward_sweep, N_ + 1);
+			y[1] = c * v[1] + e * (v[0] + v[2]) + a * lower;
+			for (int j = 2; j <= std::min(p, (int)N_ - 1); j++)
+			{
+				y[j] = (c * v[j] + e * (v[j - 1] + v[j + 1])) - low[j - 1] * y[j - 1];
+			}
+			for (int j = std::max(p + 1, 2); j < N_; j++)
+			{
+				y[j] = (c * v[j] + e * (v[j - 1] + v[j + 1])) - low_limit * y[j - 1];
+			}
+		}
+
+		/// Solution to the problem Ux=y, the boundary nodes taking the boundary conditions
+		ENSIIE_PROFILE_SCOPE(back_substitution, N_ + 1);
+		v[0] = lower;
+		v[N_] = upper;
+		for (int j = N_ - 1; j > p; j--)
+		{
+			v[j] = (y[j] + a * v[j + 1]) * inv_limit;
+		}
+		for (int j = std::min(p, (int)N_ - 1); j >= 1; j--)
+		{
+			v[j] = (y[j] + a * v[j + 1]) / up[j - 1];
+		}
+	}
+
+	void Reduced::sweep(std::vector<double>& v)
+	{
+		Trace::Scope trace("sweep", "reduced", -1, typeid(*this).name(), N_, M_);
+
+		if (tolerance_ > 0)
+		{
+			adaptive_sweep(v);
+			return;
+		}
+
+		/// Scratch buffers of the thread, given back at the end of the sweep
+		PricingWorkspace& workspace = PricingWorkspace::local();
+		PricingWorkspace::Scope scope(workspace);
+		std::vector<double>& y = workspace.acquire(N_ + 1);
+		std::vector<double>& recorded = workspace.acquire(surface_ ? N_ + 1 : 0);
+
+		v.resize(N_ + 1);
+
+		/// Terminal condition for t=T, or layer of the last checkpoint
+		int first = 1;
+		int done = 0;
+		if (checkpoint_ && checkpoint_->restore(*this, checkpoint_kind(), done, v))
+		{
+			first = done + 1;
+		}
+		else
+		{
+			terminal_condition(v);
+			if (surface_)
+			{
+				record_layer((int)M_, v, recorded);
+			}
+		}
+
+		/// Rannacher start-up, two implicit half steps
+		if (first == 1 && scheme_theta_ < 1)
+		{
+			std::vector<double>& low = workspace.acquire(0);
+			std::vector<double>& up = workspace.acquire(0);
+			double half = 0.5 * dt_changed_;
+			factorization(0.5 * theta_, low, up);
+			theta_step(v, 0.5 * theta_, 1, low, up, lower_boundary(half), upper_boundary(half), y);
+			theta_step(v, 0.5 * theta_, 1, low, up, lower_boundary(t_changed_[1]), upper_boundary(t_changed_[1]), y);
+			first = 2;
+
+			if (surface_)
+			{
+				record_layer((int)M_ - 1, v, recorded);
+			}
+			if (checkpoint_ && 1 < M_ && checkpoint_->due(1))
+			{
+				checkpoint_->save(*this, checkpoint_kind(), 1, v);
+			}
+		}
+
+		/// Iterative solution, one layer after the other
+		for (int i = first; i <= M_; i++)
+		{
+			theta_step(v, theta_, scheme_theta_, low_, up_, lower_boundary(t_changed_[i]), upper_boundary(t_changed_[i]), y);
+
+			if (surface_)
+			{
+				record_layer((int)M_ - i, v, recorded);
+			}
+			if (checkpoint_ && i < M_ && checkpoint_->due(i))
+			{
+				checkpoint_->save(*this, checkpoint_kind(), i, v);
+			}
+		}
+
+		if (checkpoint_)
+		{
+			checkpoint_->clear();
+		}
+		steps_ = (int)M_;
+	}
+
+	std::string Reduced::checkpoint_kind() const
+	{
+		return std::string(typeid(*this).name()) + " theta " + std::to_string(scheme_theta_);
+	}
+
+	void Reduced::record_layer(int i, const std::vector<double>& v, std::vector<double>& buffer) const
+	{
+		buffer.assign(v.begin(), v.end());
+		price_transformation(buffer, t_changed_[(int)M_ - i]);
+		surface_->write_layer(i, buffer);
+	}
+
+	void Reduced::adaptive_sweep(std::vector<double>& v)
+	{
+		PricingWorkspace& workspace = PricingWorkspace::local();
+		PricingWorkspace::Scope scope(workspace);
+		std::vector<double>& start = workspace.acquire(N_ + 1);
+		std::vector<double>& full = workspace.acquire(N_ + 1);
+		std::vector<double>& y = workspace.acquire(N_ + 1);
+
+		v.resize(N_ + 1);
+
+		/// Factorizations for the steps dt_changed_ * 2^(k-1), the half step being at index 0
+		std::vector<std::vector<double>> low_cache, up_cache;
+		std::vector<double> low_full, up_full, low_half, up_half;
+
+		/// Terminal condition for t=T
+		terminal_condition(v);
+
+		double tau_max = t_changed_[M_];
+		double tau = 0;
+		double eps = 1e-12 * tau_max;
+		int level = 0;
+		steps_ = 0;
+
+		/// Ratio of the local errors of two consecutive step sizes
+		double growth = (scheme_theta_ == 0.5) ? 8 : 4;
+
+		while (tau < tau_max - eps)
+		{
+			double scale = std::ldexp(1.0, level);
+			bool shortened = (tau + scale * dt_changed_ >= tau_max - eps);
+
+			const std::vector<double>* lf;
+			const std::vector<double>* uf;
+			const std::vector<double>* lh;
+			const std::vector<double>* uh;
+
+			/// The last step is shortened to stop at t=0
+			if (shortened)
+			{
+				scale = (tau_max - tau) / dt_changed_;
+				factorization(scheme_theta_ * scale * theta_, low_full, up_full);
+				factorization(scheme_theta_ * 0.5 * scale * theta_, low_half, up_half);
+				lf = &low_full;
+				uf = &up_full;
+				lh = &low_half;
+				uh = &up_half;
+			}
+			else
+			{
+				while ((int)low_cache.size() < level + 2)
+				{
+					low_cache.emplace_back();
+					up_cache.emplace_back();
+					factorization(scheme_theta_ * std::ldexp(theta_, (int)low_cache.size() - 2), low_cache.back(), up_cache.back());
+				}
+				lf = &low_cache[level + 1];
+				uf = &up_cache[level + 1];
+				lh = &low_cache[level];
+				uh = &up_cache[level];
+			}
+
+			/// One full step and two half steps, the layer being kept in case of rejection
+			double middle = tau + 0.5 * scale * dt_changed_;
+			double end = shortened ? tau_max : tau + scale * dt_changed_;
+			start = v;
+			full = v;
+			theta_step(full, scale * theta_, scheme_theta_, *lf, *uf, lower_boundary(end), upper_boundary(end), y);
+			theta_step(v, 0.5 * scale * theta_, scheme_theta_, *lh, *uh, lower_boundary(middle), upper_boundary(middle), y);
+			theta_step(v, 0.5 * scale * theta_, scheme_theta_, *lh, *uh, lower_boundary(end), upper_boundary(end), y);
+
+			double error = 0;
+			for (int j = 0; j <= N_; j++)
+			{
+				error = std::max(error, std::fabs(v[j] - full[j]));
+			}
+
+			/// Rejection, the layer is restored and the step halved, down to dt_changed_, a step of level 0
+			/// shortened to t=0 being dt_changed_ up to rounding at most
+			if (error > tolerance_ && level > 0 && scale > 1)
+			{
+				v = start;
+				level = std::max(0, level - 1);
+				while (level > 0 && tau + std::ldexp(dt_changed_, level) >= tau_max - eps)
+				{
+					level--;
+				}
+				continue;
+			}
+
+			tau = end;
+			steps_++;
+
+			if (error < tolerance_ / growth && std::ldexp(dt_changed_, level + 1) <= tau_max)
+			{
+				level++;
+			}
+		}
+	}
+
+	double Reduced::terminal(double x) const
+	{
+		(void)x;
+		throw std::logic_error("The terminal condition is not defined for this engine");
+	}
+
+	double Reduced::lower_boundary(double tau) const
+	{
+		(void)tau;
+		throw std::logic_error("The boundary conditions are not defined for this engine");
+	}
+
+	double Reduced::upper_boundary(double tau) const
+	{
+		(void)tau;
+		throw std::logic_error("The boundary conditions are not defined for this engine");
+	}
+
+	void Reduced::terminal_condition(std::vector<double>& v) const
+	{
+		ENSIIE_PROFILE_SCOPE(boundaries, N_ + 1);
+		for (int j = 0; j <= N_; j++)
+		{
+			v[j] = terminal(l_changed_[j]);
+		}
+	}
+
+	double Reduced::get_theta() const
+	{
+		return theta_;
+	}
+
+	std::vector<double> Reduced::get_low() const
+	{
+		/// The rows after the transient prefix hold the limit value
+		std::vector<double> low(low_);
+		low.resize(N_ + 1, low_.back());
+		return low;
+	}
+
+	std::vector<double> Reduced::get_up() const
+	{
+		/// The rows after the transient prefix hold the limit value
+		std::vector<double> up(up_);
+		up.resize(N_ + 1, up_.back());
+		return up;
+	}
+
+	void Reduced::set_scheme_theta(double w)
+	{
+		if (w < 0.5 || w > 1)
+		{
+			throw std::invalid_argument("The weight of the theta-scheme must be in [1/2, 1]");
+		}
+
+		scheme_theta_ = w;
+		lu_factorization();
+	}
+
+	double Reduced::get_scheme_theta() const
+	{
+		return scheme_theta_;
+	}
+
+	void Reduced::set_surface(SurfaceWriter* surface)
+	{
+		if (surface && tolerance_ > 0)
+		{
+			throw std::invalid_argument("A recorded sweep uses uniform time steps, it can not be adaptive");
+		}
+
+		surface_ = surface;
+	}
+
+	void Reduced::set_checkpoint(Checkpoint* checkpoint)
+	{
+		if (checkpoint && tolerance_ > 0)
+		{
+			throw std::invalid_argument("A checkpointed sweep uses uniform time steps, it can not be adaptive");
+		}
+
+		checkpoint_ = checkpoint;
+	}
+
+	void Reduced::set_tolerance(double tol)
+	{
+		if (tol < 0)
+		{
+			throw std::invalid_argument("The tolerance must be non-negative");
+		}
+		if (tol > 0 && (surface_ || checkpoint_))
+		{
+			throw std::invalid_argument("A recorded or checkpointed sweep uses uniform time steps, it can not be adaptive");
+		}
+
+		tolerance_ = tol;
+	}
+
+	double Reduced::get_tolerance() const
+	{
+		return tolerance_;
+	}
+
+	int Reduced::get_steps() const
+	{
+		return steps_;
+	}
 }
\ No newline at end of file
@@ -1,104 +1,309 @@
-#pragma once
-#include "change.h"
-#include <algorithm>
-
-namespace ensiie
-{
-	/**
-	 * @class Reduced
-	 * @brief A base abstract class for solving financial models using implicit finite differences methods.
-	 *
-	 * The `Reduced` class extends the `Data` and 'Change' classes and serves as an abstract base for solving
-	 * the modified partial differential equations (PDEs) related to call and put options pricing.
-	 * It provides the structure and common functionality for subclasses, involved in deterining prices
-	 * for call and put options, computing coefficient used in implicit finite differences schemes,
-	 * performing LU factorization of the coefficients' matrix, and providing access to the computed values.
-	 *
-	 * @details
-	 * This abstract class includes the method for LU factorization for efficient solving of tridiagonal systems.
-	 *
-	 * Subclasses derived from `Reduced` implement the specific algorithm of the PDE solver, including
-	 * terminal condition, to get the modified european call and put option pricing.
-	 *
-	 * The class can be initialized via direct parameter input or using an existing `Data` object.
-	 *
-	 * @note This class cannot be instantiated directly due to its abstract nature.
-	 */
-	class Reduced : public Change
-	{
-	protected:
-		double theta_; /**< Parameter to solve the linear system.*/
-		std::vector<double> low_;
-		std::vector<double> up_;
-
-		/**
-		 * @brief Performs LU factorization of the system's matrix for implicit finite differences scheme.
-		 *
-		 * This method calculates the lower (low) and upper (up) matrices, which are
-		 * used to solve the system of equations iteratively.
-		 */
-		void lu_factorization();
-
-	public:
-
-		/**
-		* @brief Constructs a Reduced object using financial parameters.
-		*
-		* Initializes the financial parameters for the option pricing model and
-		* calculates change of variables, parameters and LU factorization.
-		*
-		* @param T Time to maturity (in years)
-		* @param r Market Risk-free interest rate
-		* @param sigma Volatility of the underlying asset
-		* @param K Strike price of the option
-		* @param L Maximum value of the underlying asset
-		* @param M Number of time steps
-		* @param N Number of price steps
-		*/
-		Reduced(double T, double r, double sigma, double K, double L, double M, double N);
-
-		/**
-		* @brief Constructs a Reduced object using an existing Data object.
-		 *
-		 * This constructor initializes the model using an existing `Data` object
-		 * and calculates change of variables, parameters and LU factorization.
-		 *
-		 * @param d A `Data` object containing the financial parameters for the model
-		*/
-		Reduced(const Data& d);
-
-		/**
-		 * @brief Pure virtual function to compute the price of the option.
-		 *
-		 * This is a pure virtual function that is implemented by its derived class.
-		 *
-		 * It defines the computation of Modified Call and Put options prices.
-		 * The specific implementation will based on different terminal conditions.
-		 *
-		 * @note Since this is a pure virtual function, `Complete` cannot be instantiated directly.
-		 */
-		virtual void pricing() = 0;
-
-		/**
-		 * @brief Gets the theta coefficient for the implicit finite differences scheme.
-		 * @return A double with the theta coefficient.
-		 */
-		double get_theta() const;
-
-		/**
-		 * @brief Gets the lower matrix values of coefficients' matrix
-		 * from the LU factorization.
-		 *
-		 * @return A vector of lower matrix values (low).
-		 */
-		std::vector<double> get_low() const;
-
-		/**
-		 * @brief Gets the upper matrix values of coefficients' matrix
-		 * from the LU factorization.
-		 *
-		 * @return A vector of upper matrix values (up).
-		 */
-		std::vector<double> get_up() const;
-	};
+#pragma once
+#include "change.h"
+#include "workspace.h"
+#include "surface.h"
+#include "checkpoint.h"
+#include <algorithm>
+#include <limits>
+#include <typeinfo>
+
+namespace ensiie
+{
+	/**
+	 * @class Reduced
+	 * @brief A base abstract class for solving financial models using implicit finite differences methods.
+	 *
+	 * The `Reduced` class extends the `Data` and 'Change' classes and serves as an abstract base for solving
+	 * the modified partial differential equations (PDEs) related to call and put options pricing.
+	 * It provides the structure and common functionality for subclasses, involved in deterining prices
+	 * for call and put options, computing coefficient used in implicit finite differences schemes,
+	 * performing LU factorization of the coefficients' matrix, and providing access to the computed values.
+	 *
+	 * @details
+	 * This abstract class includes the method for LU factorization for efficient solving of tridiagonal systems.
+	 *
+	 * Subclasses derived from `Reduced` implement the specific algorithm of the PDE solver, including
+	 * terminal condition, to get the modified european call and put option pricing.
+	 *
+	 * The class can be initialized via direct parameter input or using an existing `Data` object.
+	 *
+	 * @note This class cannot be instantiated directly due to its abstract nature.
+	 */
+	class Reduced : public Change
+	{
+	protected:
+		double theta_; /**< Parameter to solve the linear system.*/
+		double scheme_theta_; /**< Weight of the implicit part of the theta-scheme, 1 for implicit and 1/2 for Crank-Nicolson.*/
+		std::vector<double> low_; /**< Transient prefix of the lower matrix values, the last one being the limit value.*/
+		std::vector<double> up_; /**< Transient prefix of the upper matrix values, the last one being the limit value.*/
+		double tolerance_; /**< Local error tolerance of the adaptive time stepping, 0 for uniform steps.*/
+		int steps_; /**< Number of time steps done by the last sweep.*/
+		SurfaceWriter* surface_; /**< Writer of the layers of the sweep, null if not recorded.*/
+		Checkpoint* checkpoint_; /**< Checkpoint of the sweep, null if not checkpointed.*/
+
+		/**
+		 * @brief Performs LU factorization of the system's matrix for implicit finite differences scheme.
+		 *
+		 * This method calculates the lower (low) and upper (up) matrices, which are
+		 * used to solve the system of equations iteratively.
+		 */
+		void lu_factorization();
+
+		/**
+		 * @brief Performs LU factorization of the system's matrix for a given theta.
+		 *
+		 * All the rows of the matrix have the same coefficients (1 + 2 theta, -theta), so the
+		 * factors follow up_i = 1 + 2 theta - theta^2 / up_i-1 and converge geometrically, with
+		 * ratio (theta / up)^2, to a limit value. Only the rows before the convergence are stored:
+		 * the factorization stops at the first row whose distance to the limit, bounded by the
+		 * last change times ratio / (1 - ratio), is below the machine precision, and this last
+		 * stored row holds the limit values used for all the others. The ratio tends to 1 for
+		 * large theta, so the last change alone would stop the factorization too early.
+		 *
+		 * @param theta Parameter of the system, proportional to the time step.
+		 * @param low Lower matrix values, overwritten with the transient prefix and the limit value.
+		 * @param up Upper matrix values, overwritten with the transient prefix and the limit value.
+		 */
+		void factorization(double theta, std::vector<double>& low, std::vector<double>& up) const;
+
+		/**
+		 * @brief Performs one step of the theta-scheme on a time layer, in-place.
+		 *
+		 * The system is (1 + 2 w theta) u_j - w theta (u_j-1 + u_j+1) = b_j with
+		 * b_j = (1 - 2 (1 - w) theta) v_j + (1 - w) theta (v_j-1 + v_j+1), w being the weight
+		 * of the implicit part, for the interior nodes 1 to N-1, the nodes 0 and N taking
+		 * the boundary conditions. The explicit part is computed in the forward elimination
+		 * pass, so each node of the old layer is read once and no right-hand side is stored.
+		 *
+		 * After the transient prefix of the factors, the rows use the limit values kept in
+		 * registers, the division by the diagonal being replaced by a product with its inverse.
+		 * For large N, only the layer and the scratch vector are then streamed.
+		 *
+		 * @param v Time layer of modified prices.
+		 * @param theta Parameter of the system for this time step.
+		 * @param w Weight of the implicit part.
+		 * @param low Lower matrix values for w * theta.
+		 * @param up Upper matrix values for w * theta.
+		 * @param lower Modified price of the node 0 at the end of the step.
+		 * @param upper Modified price of the node N at the end of the step.
+		 * @param y Scratch vector for the forward substitution.
+		 */
+		void theta_step(std::vector<double>& v, double theta, double w, const std::vector<double>& low, const std::vector<double>& up,
+			double lower, double upper, std::vector<double>& y) const;
+
+		/**
+		 * @brief Solves the modified PDE from the terminal condition and returns the last layer.
+		 *
+		 * Uniform steps of `dt_changed_` are used, unless a tolerance has been set with
+		 * `set_tolerance()`. When the scheme is not fully implicit, the first step is replaced
+		 * by two implicit half steps (Rannacher start-up) to damp the oscillations coming
+		 * from the kink of the terminal condition.
+		 *
+		 * The scratch buffers come from the workspace of the calling thread and the result is
+		 * written in place, so repeated sweeps on the same grid do not allocate memory.
+		 *
+		 * When a surface writer is set, each layer is written once computed, see `record_layer()`.
+		 * With a checkpoint, the sweep resumes from the saved layer. Both require the uniform
+		 * steps, the setters rejecting a tolerance.
+		 *
+		 * @param v Vector overwritten with the modified prices at time 0.
+		 */
+		void sweep(std::vector<double>& v);
+
+		/**
+		 * @brief Writes a layer of modified prices in the surface file.
+		 *
+		 * The layer is transformed back with `price_transformation()`, as the prices at time 0
+		 * are by `pricing()`, so that the file holds prices on the asset price grid.
+		 *
+		 * @param i Time index of the layer.
+		 * @param v Modified prices at the time t_i.
+		 * @param buffer Scratch vector receiving the prices.
+		 */
+		void record_layer(int i, const std::vector<double>& v, std::vector<double>& buffer) const;
+
+		/**
+		 * @brief Describes the engine and the scheme, so that a checkpoint is resumed by the same solve.
+		 * @return The dynamic type of the engine and the weight of the implicit part.
+		 */
+		std::string checkpoint_kind() const;
+
+		/**
+		 * @brief Solves the modified PDE with adaptive time steps and returns the last layer.
+		 *
+		 * The time steps are `dt_changed_` times a power of two, starting with `dt_changed_`
+		 * near the terminal condition. The local error is estimated by step doubling: the
+		 * step is rejected and halved when the error exceeds the tolerance, and doubled when
+		 * it is below a quarter of it (an eighth for Crank-Nicolson), according to the order
+		 * of the local error. The factorizations are kept for each step size.
+		 *
+		 * @param v Vector overwritten with the modified prices at time 0.
+		 */
+		void adaptive_sweep(std::vector<double>& v);
+
+		/**
+		 * @brief Computes the terminal condition of the modified PDE.
+		 *
+		 * @param x Transformed underlying asset price.
+		 * @return The modified payoff.
+		 * @throws std::logic_error If the engine does not define a terminal condition.
+		 */
+		virtual double terminal(double x) const;
+
+		/**
+		 * @brief Computes the boundary condition of the modified PDE for the first node of `l_changed_`.
+		 *
+		 * @param tau Transformed time.
+		 * @return The modified price of the node 0 at tau.
+		 * @throws std::logic_error If the engine does not define a boundary condition.
+		 */
+		virtual double lower_boundary(double tau) const;
+
+		/**
+		 * @brief Computes the boundary condition of the modified PDE for the last node of `l_changed_`.
+		 *
+		 * @param tau Transformed time.
+		 * @return The modified price of the node N at tau.
+		 * @throws std::logic_error If the engine does not define a boundary condition.
+		 */
+		virtual double upper_boundary(double tau) const;
+
+		/**
+		 * @brief Computes the terminal condition on the whole grid `l_changed_`.
+		 *
+		 * By default `terminal()` is called node after node. The engines whose payoff is a
+		 * function of the factors `weight_` override it with a loop without exponential.
+		 *
+		 * @param v Vector overwritten with the terminal condition, of size N+1.
+		 */
+		virtual void terminal_condition(std::vector<double>& v) const;
+
+	public:
+
+		/**
+		* @brief Constructs a Reduced object using financial parameters.
+		*
+		* Initializes the financial parameters for the option pricing model and
+		* calculates change of variables, parameters and LU factorization.
+		*
+		* @param T Time to maturity (in years)
+		* @param r Market Risk-free interest rate
+		* @param sigma Volatility of the underlying asset
+		* @param K Strike price of the option
+		* @param L Maximum value of the underlying asset
+		* @param M Number of time steps
+		* @param N Number of price steps
+		*/
+		Reduced(double T, double r, double sigma, double K, double L, double M, double N);
+
+		/**
+		* @brief Constructs a Reduced object using an existing Data object.
+		 *
+		 * This constructor initializes the model using an existing `Data` object
+		 * and calculates change of variables, parameters and LU factorization.
+		 *
+		 * @param d A `Data` object containing the financial parameters for the model
+		*/
+		Reduced(const Data& d);
+
+		/**
+		 * @brief Pure virtual function to compute the price of the option.
+		 *
+		 * This is a pure virtual function that is implemented by its derived class.
+		 *
+		 * It defines the computation of Modified Call and Put options prices.
+		 * The specific implementation will based on different terminal conditions.
+		 *
+		 * @note Since this is a pure virtual function, `Complete` cannot be instantiated directly.
+		 */
+		virtual void pricing() = 0;
+
+		/**
+		 * @brief Gets the theta coefficient for the implicit finite differences scheme.
+		 * @return A double with the theta coefficient.
+		 */
+		double get_theta() const;
+
+		/**
+		 * @brief Gets the lower matrix values of coefficients' matrix
+		 * from the LU factorization.
+		 *
+		 * Only the transient prefix being stored, the vector is built and returned by value.
+		 *
+		 * @return A vector of lower matrix values (low).
+		 */
+		std::vector<double> get_low() const;
+
+		/**
+		 * @brief Gets the upper matrix values of coefficients' matrix
+		 * from the LU factorization.
+		 *
+		 * Only the transient prefix being stored, the vector is built and returned by value.
+		 *
+		 * @return A vector of upper matrix values (up).
+		 */
+		std::vector<double> get_up() const;
+
+		/**
+		 * @brief Sets the weight of the implicit part of the theta-scheme.
+		 *
+		 * The LU factorization is computed again for the new scheme.
+		 *
+		 * @param w Weight, 1 for the implicit scheme used by default and 1/2 for Crank-Nicolson.
+		 * @throws std::invalid_argument If `w` is not in [1/2, 1], where the scheme is stable.
+		 */
+		void set_scheme_theta(double w);
+
+		/**
+		 * @brief Gets the weight of the implicit part of the theta-scheme.
+		 * @return The weight w.
+		 */
+		double get_scheme_theta() const;
+
+		/**
+		 * @brief Records the layers of the next sweeps in a surface file.
+		 *
+		 * The layer of each time t_i is written as soon as it is computed, so the sweep must use
+		 * uniform steps. The writer is not owned and must outlive the sweeps,
+		 * `SurfaceWriter::close()` being called by the caller.
+		 *
+		 * @param surface Writer created with the `Data` of this engine, null to stop recording.
+		 * @throws std::invalid_argument If `surface` is not null and a tolerance is set.
+		 */
+		void set_surface(SurfaceWriter* surface);
+
+		/**
+		 * @brief Checkpoints the next sweeps, and resumes them from the saved layer.
+		 *
+		 * The sweep saves its layer of modified prices every `Checkpoint::get_interval()`
+		 * steps. A sweep started with the checkpoint file of the same solve on disk continues
+		 * from it. The sweep must use uniform steps, as with `set_surface()`,
+		 * and removes the file once complete. The checkpoint is not owned and must outlive
+		 * the sweeps.
+		 *
+		 * @param checkpoint Checkpoint, null to stop checkpointing.
+		 * @throws std::invalid_argument If `checkpoint` is not null and a tolerance is set.
+		 */
+		void set_checkpoint(Checkpoint* checkpoint);
+
+		/**
+		 * @brief Sets the local error tolerance of the adaptive time stepping.
+		 *
+		 * @param tol Tolerance on the modified prices for each time step, 0 to use uniform steps.
+		 * @throws std::invalid_argument If `tol` is negative, or positive with a surface writer or a checkpoint set.
+		 */
+		void set_tolerance(double tol);
+
+		/**
+		 * @brief Gets the local error tolerance of the adaptive time stepping.
+		 * @return The tolerance, 0 for uniform steps.
+		 */
+		double get_tolerance() const;
+
+		/**
+		 * @brief Gets the number of time steps done by the last call to `pricing()`.
+		 * @return Number of accepted time steps.
+		 */
+		int get_steps() const;
+	};
 }
\ No newline at end of file
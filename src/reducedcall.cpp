@@ -1,70 +1,48 @@
-#include "reducedcall.h"
-
-namespace ensiie
-{
-	ReducedCall::ReducedCall(double T, double r, double sigma, double K, double L, double M, double N) : Reduced(T, r, sigma, K, L, M, N) {};
-	ReducedCall::ReducedCall(const Data& d) : Reduced(d) {};
-
-	void ReducedCall::pricing()
-	{
-		/// In the methods the matrix prices has the form prices[raws j],[columns i]
-		std::vector<std::vector<double>> prices(N_ + 1, std::vector<double>(M_ + 1));
-		std::vector<double> b(N_ + 1);
-		std::vector<double> y(N_ + 1);
-
-		/// Terminal condition for t=T
-		for (int j = 0; j <= N_; j++)
-		{
-			prices[j][0] = std::max(0.0, exp(0.5 * (f_ + 1) * l_changed_[j]) - exp(0.5 * (f_ - 1) * l_changed_[j]));
-		}
-
-		/// Iterative solution of the matrix prices by column
-		for (int i = 1; i <= M_; i++) {
-
-			/// Solution to the problem Ly=b, computing b and then y
-			for (int j = 0; j <= N_; j++)
-			{
-				b[j] = prices[j][i - 1];
-
-				if (j == 0)
-				{
-					y[j] = b[j];
-				}
-				else
-				{
-					y[j] = b[j] - low_[j] * y[j - 1];
-				}
-			}
-
-			/// Solution to the problem Ux=y
-			for (int j = N_; j > 0; j--)
-			{
-				if (j == N_)
-				{
-					prices[j][i] = y[j] / up_[j];
-				}
-				else
-				{
-					prices[j][i] = (y[j] + theta_ * prices[j+1][i]) / up_[j];
-				}
-			}
-		}
-
-		/// Extraction of the column of the matrix corresponding to C_tilda(0, s)
-		std::vector<double> price(N_ + 1);
-		std::vector<double> correct_price(N_ + 1);
-		for (int i = 0; i <= N_; i++)
-		{
-			price[i] = prices[i][M_];
-		}
-
-		///Changing of the price vector with real prices
-		correct_price = price_transformation(price);
-		this->price_ = correct_price;
-	}
-
-	std::vector<double> ReducedCall::get_price() const
-	{
-		return price_;
-	}
+#include "reducedcall.h"
+#include "profile.h"
+
+namespace ensiie
+{
+	ReducedCall::ReducedCall(double T, double r, double sigma, double K, double L, double M, double N) : Reduced(T, r, sigma, K, L, M, N) {};
+	ReducedCall::ReducedCall(const Data& d) : Reduced(d) {};
+
+	double ReducedCall::terminal(double x) const
+	{
+		return std::max(0.0, exp(0.5 * (f_ + 1) * x) - exp(0.5 * (f_ - 1) * x));
+	}
+
+	void ReducedCall::terminal_condition(std::vector<double>& v) const
+	{
+		ENSIIE_PROFILE_SCOPE(boundaries, N_ + 1);
+		/// e^((f+1)x/2) - e^((f-1)x/2) = e^((f-1)x/2) (s/K - 1)
+		for (int j = 0; j <= N_; j++)
+		{
+			double s = moneyness_[j];
+			v[j] = std::max(0.0, weight_[j] * (s - 1));
+		}
+	}
+
+	double ReducedCall::lower_boundary(double tau) const
+	{
+		(void)tau;
+		return 0;
+	}
+
+	double ReducedCall::upper_boundary(double tau) const
+	{
+		/// s - K e^(-r(T-t)), the discount being e^(-f tau), with the factors of the change
+		return weight_[N_] * (moneyness_[N_] * growth(tau) - discounted_growth(tau));
+	}
+
+	void ReducedCall::pricing()
+	{
+		/// Solution of the modified PDE and change of the C_tilda(0, s) vector with real prices
+		sweep(this->price_);
+		price_transformation(this->price_, t_changed_[M_]);
+	}
+
+	const std::vector<double>& ReducedCall::get_price() const
+	{
+		return price_;
+	}
 }
\ No newline at end of file
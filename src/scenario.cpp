@@ -0,0 +1,161 @@
+#include "scenario.h"
+#include "trace.h"
+
+namespace ensiie
+{
+	Scenario::Scenario(const Data& d, bool call, double S0) : base_(d), call_(call), S0_(S0), spot_shocks_(1, 0), vol_shocks_(1, 0), rate_shocks_(1, 0), threads_(0), solves_(0)
+	{
+		if (S0 < 0 || S0 > d.get_L())
+		{
+			throw std::invalid_argument("S0 must be between 0 and L");
+		}
+	}
+
+	void Scenario::set_shocks(const std::vector<double>& spot, const std::vector<double>& vol, const std::vector<double>& rate)
+	{
+		std::vector<double> spot_shocks = spot.empty() ? std::vector<double>(1, 0) : spot;
+		std::vector<double> vol_shocks = vol.empty() ? std::vector<double>(1, 0) : vol;
+		std::vector<double> rate_shocks = rate.empty() ? std::vector<double>(1, 0) : rate;
+
+		// Exceptions are raised here, the solves running in threads
+		for (double shock : spot_shocks)
+		{
+			double s = S0_ * (1 + shock);
+			if (s < 0 || s > base_.get_L())
+			{
+				throw std::invalid_argument("The shocked spot prices must be between 0 and L");
+			}
+		}
+
+		for (double shock : vol_shocks)
+		{
+			if (base_.get_sigma() + shock <= 0)
+			{
+				throw std::invalid_argument("The shocked volatilities must be positive");
+			}
+		}
+
+		for (double shock : rate_shocks)
+		{
+			if (base_.get_r() + shock < 0)
+			{
+				throw std::invalid_argument("The shocked rates must be non-negative");
+			}
+		}
+
+		spot_shocks_ = std::move(spot_shocks);
+		vol_shocks_ = std::move(vol_shocks);
+		rate_shocks_ = std::move(rate_shocks);
+	}
+
+	void Scenario::set_threads(unsigned int threads)
+	{
+		threads_ = threads;
+	}
+
+	double Scenario::interpolate(const std::vector<double>& v, double s) const
+	{
+		double x = s / base_.get_ds();
+		int j = std::min((int)x, (int)base_.get_N() - 1);
+		double w = x - j;
+
+		return (1 - w) * v[j] + w * v[j + 1];
+	}
+
+	void Scenario::pricing()
+	{
+		// Distinct (r, sigma) pairs not yet solved
+		std::vector<std::pair<double, double>> pairs;
+		for (double rate : rate_shocks_)
+		{
+			for (double vol : vol_shocks_)
+			{
+				std::pair<double, double> key(base_.get_r() + rate, base_.get_sigma() + vol);
+				if (solved_.count(key) == 0 && std::find(pairs.begin(), pairs.end(), key) == pairs.end())
+				{
+					pairs.push_back(key);
+				}
+			}
+		}
+
+		int n = (int)pairs.size();
+		unsigned int n_threads = threads_ ? threads_ : std::max(1u, std::thread::hardware_concurrency());
+		n_threads = std::min(n_threads, (unsigned int)std::max(n, 1));
+		std::vector<std::vector<double>> prices(n);
+
+		// One engine per pair, the pairs being shared between threads
+		std::vector<std::thread> threads;
+		for (unsigned int p = 0; p < n_threads; p++)
+		{
+			threads.emplace_back([&, p]()
+			{
+				for (int k = p; k < n; k += n_threads)
+				{
+					Trace::Scope trace("solve", "scenario", k);
+					Data d(base_, pairs[k].first, pairs[k].second);
+
+					if (call_)
+					{
+						CompleteCall c(d);
+						c.set_threads(n_threads > 1 ? 1 : 0);
+						c.pricing();
+						prices[k] = c.get_price();
+					}
+					else
+					{
+						CompletePut c(d);
+						c.set_threads(n_threads > 1 ? 1 : 0);
+						c.pricing();
+						prices[k] = c.get_price();
+					}
+				}
+			});
+		}
+
+		for (auto& th : threads)
+		{
+			th.join();
+		}
+
+		for (int k = 0; k < n; k++)
+		{
+			solved_[pairs[k]] = std::move(prices[k]);
+		}
+		solves_ = n;
+
+		// Spot shocks read from the price vector of their pair
+		int n_spot = (int)spot_shocks_.size();
+		int n_vol = (int)vol_shocks_.size();
+		std::vector<double> ladder(n_spot * n_vol * rate_shocks_.size());
+
+		for (int i_rate = 0; i_rate < (int)rate_shocks_.size(); i_rate++)
+		{
+			for (int i_vol = 0; i_vol < n_vol; i_vol++)
+			{
+				const std::vector<double>& v = solved_.at(std::make_pair(base_.get_r() + rate_shocks_[i_rate], base_.get_sigma() + vol_shocks_[i_vol]));
+
+				for (int i_spot = 0; i_spot < n_spot; i_spot++)
+				{
+					ladder[(i_rate * n_vol + i_vol) * n_spot + i_spot] = interpolate(v, S0_ * (1 + spot_shocks_[i_spot]));
+				}
+			}
+		}
+
+		ladder_ = std::move(ladder);
+	}
+
+	double Scenario::get_price(int spot, int vol, int rate) const
+	{
+		return ladder_[(rate * vol_shocks_.size() + vol) * spot_shocks_.size() + spot];
+	}
+
+	const std::vector<double>& Scenario::get_ladder() const
+	{
+		return ladder_;
+	}
+
+	int Scenario::get_solves() const
+	{
+		return solves_;
+	}
+}
\ No newline at end of file
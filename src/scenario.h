@@ -0,0 +1,104 @@
+#pragma once
+#include "completecall.h"
+#include "completeput.h"
+#include <map>
+#include <utility>
+
+namespace ensiie
+{
+	/**
+	 * @class Scenario
+	 * @brief A class to price a European option under a grid of spot, volatility and rate shocks.
+	 *
+	 * @details
+	 * The ladder is the product of three lists of shocks: relative shocks of the spot S0,
+	 * absolute shocks of the volatility and absolute shocks of the rate. A `Complete` engine
+	 * gives the prices for every level of the spot grid, so the scenarios differing only by
+	 * the spot share a single solve and are read from its price vector by linear interpolation.
+	 *
+	 * One solve is made for each distinct (r, sigma) pair, on the grid of the base contract,
+	 * which is shared with it when the rate is unchanged. The solves are independent and run
+	 * in parallel, one engine per pair. Their price vectors are kept between the calls of
+	 * `pricing()`, so that changing the shocks only solves the pairs not yet priced.
+	 */
+	class Scenario
+	{
+		Data base_; /**< Base contract and grid.*/
+		bool call_; /**< True for a call option, false for a put option.*/
+		double S0_; /**< Spot price of the base scenario.*/
+		std::vector<double> spot_shocks_; /**< Relative shocks of the spot price.*/
+		std::vector<double> vol_shocks_; /**< Absolute shocks of the volatility.*/
+		std::vector<double> rate_shocks_; /**< Absolute shocks of the rate.*/
+		unsigned int threads_; /**< Number of threads, 0 for the number of hardware threads.*/
+		std::map<std::pair<double, double>, std::vector<double>> solved_; /**< Prices on the grid for each (r, sigma) already solved.*/
+		std::vector<double> ladder_; /**< Prices of the scenarios.*/
+		int solves_; /**< Number of solves of the last call of `pricing()`.*/
+
+		/**
+		 * @brief Interpolates a price vector of the grid at a spot price.
+		 *
+		 * @param v Prices on the grid.
+		 * @param s Spot price.
+		 * @return The interpolated price.
+		 */
+		double interpolate(const std::vector<double>& v, double s) const;
+
+	public:
+
+		/**
+		 * @brief Constructs a Scenario object with no shock.
+		 *
+		 * @param d A `Data` object containing the base contract and the grid
+		 * @param call True for a call option, false for a put option
+		 * @param S0 Spot price of the base scenario
+		 *
+		 * @throws std::invalid_argument If `S0` is not in [0, L].
+		 */
+		Scenario(const Data& d, bool call, double S0);
+
+		/**
+		 * @brief Sets the shocks of the ladder, an empty list meaning no shock.
+		 *
+		 * @param spot Relative shocks of the spot price, S0 becoming S0 (1 + shock).
+		 * @param vol Absolute shocks of the volatility.
+		 * @param rate Absolute shocks of the rate.
+		 *
+		 * @throws std::invalid_argument If a shocked spot is not in [0, L], a shocked volatility
+		 * is not positive or a shocked rate is negative.
+		 */
+		void set_shocks(const std::vector<double>& spot, const std::vector<double>& vol, const std::vector<double>& rate);
+
+		/**
+		 * @brief Sets the number of threads used for the solves.
+		 * @param threads Number of threads, 0 for the number of hardware threads.
+		 */
+		void set_threads(unsigned int threads);
+
+		/**
+		 * @brief Solves the (r, sigma) pairs not yet priced and computes the prices of the ladder.
+		 */
+		void pricing();
+
+		/**
+		 * @brief Gets the price of a scenario.
+		 *
+		 * @param spot Index of the spot shock.
+		 * @param vol Index of the volatility shock.
+		 * @param rate Index of the rate shock.
+		 * @return The price of the option in this scenario.
+		 */
+		double get_price(int spot, int vol, int rate) const;
+
+		/**
+		 * @brief Gets the prices of all the scenarios.
+		 * @return A vector of prices, the spot shock varying fastest, then the volatility one.
+		 */
+		const std::vector<double>& get_ladder() const;
+
+		/**
+		 * @brief Gets the number of solves of the last call of `pricing()`.
+		 * @return Number of (r, sigma) pairs solved, the others being read from the previous calls.
+		 */
+		int get_solves() const;
+	};
+}
\ No newline at end of file
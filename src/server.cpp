@@ -0,0 +1,444 @@
+#include "server.h"
+#include "trace.h"
+#include <cstring>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#define ENSIIE_UNIX_SOCKET
+#endif
+
+namespace ensiie
+{
+	/**
+	 * @brief Socket of a client, closed when the last request referring to it is answered.
+	 */
+	struct Server::Connection
+	{
+		int fd; /**< Socket of the connection.*/
+
+		explicit Connection(int f) : fd(f) {};
+
+		~Connection()
+		{
+#ifdef ENSIIE_UNIX_SOCKET
+			close(fd);
+#endif
+		}
+
+		/**
+		 * @brief Writes a message, ignoring the errors of a closed connection.
+		 * @param data First byte of the message.
+		 * @param size Number of bytes.
+		 */
+		void write(const char* data, std::size_t size)
+		{
+#ifdef ENSIIE_UNIX_SOCKET
+			while (size > 0)
+			{
+				ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+				if (n <= 0)
+				{
+					if (n < 0 && errno == EINTR)
+					{
+						continue;
+					}
+					return;
+				}
+				data += n;
+				size -= n;
+			}
+#else
+			(void)data;
+			(void)size;
+#endif
+		}
+	};
+
+	Server::Server(const std::string& path, double window, std::size_t cache_size) : path_(path), window_(window), listen_fd_(-1), running_(false), readers_(0), cache_(cache_size), next_latency_(0), requests_(0), batches_(0), solves_(0)
+	{
+		if (path.empty() || path.size() >= 100 || window < 0)
+		{
+			throw std::invalid_argument("The path must be non-empty and shorter than 100 characters, and the window non-negative");
+		}
+	}
+
+	Server::~Server()
+	{
+		stop();
+	}
+
+	void Server::set_threads(unsigned int threads)
+	{
+		cache_.set_threads(threads);
+	}
+
+	void Server::parse_line(const std::string& line, Request& request) const
+	{
+		std::istringstream in(line);
+		std::string type;
+		in >> type;
+
+		if (type == "stats")
+		{
+			request.stats = true;
+			return;
+		}
+
+		Contract& c = request.contract;
+		in >> c.T >> c.r >> c.sigma >> c.K >> c.L >> c.M >> c.N >> c.S;
+
+		if ((type != "call" && type != "put") || in.fail())
+		{
+			request.error = "malformed request";
+		}
+		c.call = (type == "call");
+	}
+
+	void Server::read_requests(std::shared_ptr<Connection> connection)
+	{
+#ifdef ENSIIE_UNIX_SOCKET
+		std::string buffer;
+		char chunk[4096];
+
+		while (true)
+		{
+			ssize_t n = recv(connection->fd, chunk, sizeof(chunk), 0);
+			if (n < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (n <= 0)
+			{
+				break;
+			}
+			buffer.append(chunk, n);
+
+			// Complete messages of the buffer, the end of the last one staying for the next read
+			std::vector<Request> requests;
+			std::size_t pos = 0;
+			while (pos < buffer.size())
+			{
+				Request request{ connection, false, false, "", Contract{ false, 0, 0, 0, 0, 0, 0, 0, 0 }, std::chrono::steady_clock::now() };
+
+				if ((unsigned char)buffer[pos] == binary_magic)
+				{
+					if (buffer.size() - pos < (std::size_t)binary_request_size)
+					{
+						break;
+					}
+
+					double values[8];
+					std::memcpy(values, buffer.data() + pos + 2, sizeof(values));
+					request.binary = true;
+					request.contract = Contract{ buffer[pos + 1] != 0, values[0], values[1], values[2], values[3], values[4], values[5], values[6], values[7] };
+					pos += binary_request_size;
+				}
+				else
+				{
+					std::size_t end = buffer.find('\n', pos);
+					if (end == std::string::npos)
+					{
+						break;
+					}
+
+					std::string line = buffer.substr(pos, end - pos);
+					pos = end + 1;
+					if (!line.empty() && line.back() == '\r')
+					{
+						line.pop_back();
+					}
+					if (line.empty())
+					{
+						continue;
+					}
+					parse_line(line, request);
+				}
+
+				requests.push_back(std::move(request));
+			}
+			buffer.erase(0, pos);
+
+			if (!requests.empty())
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				for (Request& request : requests)
+				{
+					queue_.push_back(std::move(request));
+				}
+				ready_.notify_one();
+			}
+
+			// A line can not be that long, the client is not speaking the protocol
+			if (buffer.size() > 65536)
+			{
+				break;
+			}
+		}
+#else
+		(void)connection;
+#endif
+	}
+
+	void Server::answer(const Request& request)
+	{
+		std::string message = request.error;
+		double values[3] = { 0, 0, 0 };
+
+		if (message.empty() && !request.stats)
+		{
+			cache_.quote(request.contract, values, message);
+		}
+
+		if (request.binary)
+		{
+			char frame[1 + sizeof(values)];
+			frame[0] = message.empty() ? 0 : 1;
+			std::memcpy(frame + 1, values, sizeof(values));
+			request.connection->write(frame, sizeof(frame));
+		}
+		else
+		{
+			std::ostringstream out;
+			out.precision(17);
+			if (request.stats)
+			{
+				out << "requests " << get_requests() << " batches " << get_batches() << " solves " << get_solves();
+				out << " p50 " << get_latency(0.5) << " p99 " << get_latency(0.99);
+			}
+			else if (!message.empty())
+			{
+				out << "error " << message;
+			}
+			else
+			{
+				out << values[0] << " " << values[1] << " " << values[2];
+			}
+			out << "\n";
+
+			std::string text = out.str();
+			request.connection->write(text.data(), text.size());
+		}
+
+		double latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - request.start).count();
+
+		std::lock_guard<std::mutex> lock(stats_mutex_);
+		if (latencies_.size() < (std::size_t)latency_samples)
+		{
+			latencies_.push_back(latency);
+		}
+		else
+		{
+			latencies_[next_latency_] = latency;
+			next_latency_ = (next_latency_ + 1) % latency_samples;
+		}
+		requests_++;
+	}
+
+	void Server::process_batches()
+	{
+		while (true)
+		{
+			std::deque<Request> batch;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				ready_.wait(lock, [&]() { return !queue_.empty() || !running_; });
+				if (queue_.empty())
+				{
+					return;
+				}
+			}
+
+			// Window letting the concurrent requests join the batch
+			if (window_ > 0)
+			{
+				std::this_thread::sleep_for(std::chrono::duration<double>(window_));
+			}
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				batch.swap(queue_);
+			}
+
+			// The contracts of the batch, priced together
+			Trace::Scope trace("batch", "server");
+			std::vector<Contract> contracts;
+			for (const Request& request : batch)
+			{
+				if (!request.stats && request.error.empty())
+				{
+					contracts.push_back(request.contract);
+				}
+			}
+			try
+			{
+				cache_.solve(contracts);
+			}
+			catch (const std::exception& e)
+			{
+				// The requests of the batch are answered with the error, the server keeps running
+				for (Request& request : batch)
+				{
+					if (!request.stats && request.error.empty())
+					{
+						request.error = e.what();
+					}
+				}
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(stats_mutex_);
+				batches_++;
+				solves_ = cache_.get_solves();
+			}
+
+			// Answers in the order of the queue, hence of the requests of each connection
+			for (const Request& request : batch)
+			{
+				answer(request);
+			}
+		}
+	}
+
+	void Server::run()
+	{
+#ifdef ENSIIE_UNIX_SOCKET
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+		{
+			throw std::runtime_error("The socket can not be created");
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			listen_fd_ = fd;
+		}
+
+		sockaddr_un address;
+		std::memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		std::strncpy(address.sun_path, path_.c_str(), sizeof(address.sun_path) - 1);
+		unlink(path_.c_str());
+
+		if (bind(fd, (sockaddr*)&address, sizeof(address)) < 0 || listen(fd, 64) < 0)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			close(fd);
+			listen_fd_ = -1;
+			throw std::runtime_error("The socket can not be bound to " + path_);
+		}
+
+		running_ = true;
+		std::thread batcher(&Server::process_batches, this);
+
+		while (running_)
+		{
+			int client = accept(fd, nullptr, nullptr);
+			if (client < 0)
+			{
+				if (running_ && errno == EINTR)
+				{
+					continue;
+				}
+				break;
+			}
+
+			auto connection = std::make_shared<Connection>(client);
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+
+				// A connection accepted while stopping is closed without reader, so that stop() does not miss it
+				if (!running_)
+				{
+					break;
+				}
+				connections_.erase(std::remove_if(connections_.begin(), connections_.end(), [](const std::weak_ptr<Connection>& c) { return c.expired(); }), connections_.end());
+				connections_.push_back(connection);
+				readers_++;
+			}
+
+			// The reader signals its end, so that the threads of closed connections are not kept
+			std::thread([this, connection]()
+			{
+				read_requests(connection);
+				std::lock_guard<std::mutex> lock(mutex_);
+				readers_--;
+				idle_.notify_all();
+			}).detach();
+		}
+
+		// Shutdown: the readers stop, then the batch thread answers the queued requests
+		stop();
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			close(listen_fd_);
+			listen_fd_ = -1;
+		}
+
+		ready_.notify_all();
+		batcher.join();
+		unlink(path_.c_str());
+#else
+		throw std::runtime_error("Unix-domain sockets are not available on this platform");
+#endif
+	}
+
+	void Server::stop()
+	{
+		running_ = false;
+#ifdef ENSIIE_UNIX_SOCKET
+		std::unique_lock<std::mutex> lock(mutex_);
+		if (listen_fd_ >= 0)
+		{
+			shutdown(listen_fd_, SHUT_RDWR);
+		}
+
+		// The reader threads capture the server, they must end before it is destroyed
+		for (auto& weak : connections_)
+		{
+			if (auto connection = weak.lock())
+			{
+				shutdown(connection->fd, SHUT_RD);
+			}
+		}
+		idle_.wait(lock, [&]() { return readers_ == 0; });
+#endif
+	}
+
+	double Server::get_latency(double q) const
+	{
+		std::vector<double> sorted;
+		{
+			std::lock_guard<std::mutex> lock(stats_mutex_);
+			sorted = latencies_;
+		}
+
+		if (sorted.empty())
+		{
+			return 0;
+		}
+
+		std::size_t k = (std::size_t)(std::min(std::max(q, 0.0), 1.0) * (sorted.size() - 1));
+		std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+		return sorted[k];
+	}
+
+	long long Server::get_requests() const
+	{
+		std::lock_guard<std::mutex> lock(stats_mutex_);
+		return requests_;
+	}
+
+	long long Server::get_batches() const
+	{
+		std::lock_guard<std::mutex> lock(stats_mutex_);
+		return batches_;
+	}
+
+	long long Server::get_solves() const
+	{
+		std::lock_guard<std::mutex> lock(stats_mutex_);
+		return solves_;
+	}
+}
\ No newline at end of file
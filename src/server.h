@@ -0,0 +1,175 @@
+#pragma once
+#include "solvecache.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace ensiie
+{
+	/**
+	 * @class Server
+	 * @brief A pricing daemon answering requests on a local Unix-domain socket.
+	 *
+	 * @details
+	 * Each message is either a line of text or a binary frame:
+	 * - `call T r sigma K L M N S` or `put T r sigma K L M N S`, answered by the line
+	 *   `price delta gamma`, or `error <message>`;
+	 * - `stats`, answered by `requests <n> batches <n> solves <n> p50 <s> p99 <s>`, the
+	 *   latencies being in seconds;
+	 * - a binary frame of `binary_request_size` bytes: the byte `binary_magic`, a byte 1 for a
+	 *   call or 0 for a put, then T, r, sigma, K, L, M, N and S as doubles in the byte order
+	 *   of the host, answered by a status byte, 0 on success, then price, delta and gamma.
+	 *
+	 * Every connection has its reader thread, which queues the requests. A single batch thread
+	 * waits for `window` seconds after the first queued request, so that the concurrent ones
+	 * join it, then takes the whole queue. The requests are priced by a `SolveCache`: those
+	 * sharing a solve are priced together, the distinct solves of a batch run in parallel and
+	 * they are kept for the next batches. The answers are written in the order of the requests
+	 * of each connection.
+	 *
+	 * The latencies, from the reception of a request to its answer, are kept for the last
+	 * `latency_samples` requests.
+	 *
+	 * The server is only available on POSIX systems; elsewhere `run()` throws.
+	 */
+	class Server
+	{
+	public:
+		static const unsigned char binary_magic = 0xB5; /**< First byte of a binary request.*/
+		static const int binary_request_size = 66; /**< Size of a binary request, in bytes.*/
+		static const int latency_samples = 100000; /**< Number of latencies kept for the percentiles.*/
+
+	private:
+		struct Connection;
+
+		/**
+		 * @brief Request waiting in the queue.
+		 */
+		struct Request
+		{
+			std::shared_ptr<Connection> connection; /**< Connection to answer on.*/
+			bool binary; /**< True for a binary request.*/
+			bool stats; /**< True for a request of the statistics.*/
+			std::string error; /**< Error found when parsing, empty if none.*/
+			Contract contract; /**< Contract to price.*/
+			std::chrono::steady_clock::time_point start; /**< Time of reception.*/
+		};
+
+		std::string path_; /**< Path of the socket.*/
+		double window_; /**< Waiting time for the requests of a batch, in seconds.*/
+		int listen_fd_; /**< Listening socket.*/
+		std::atomic<bool> running_; /**< False once `stop()` is called.*/
+
+		std::mutex mutex_; /**< Protects the queue, the connections and the listening socket.*/
+		std::condition_variable ready_; /**< Signals a queued request or the stop.*/
+		std::condition_variable idle_; /**< Signals the end of a reader thread.*/
+		int readers_; /**< Number of running reader threads.*/
+		std::deque<Request> queue_; /**< Requests waiting for the next batch.*/
+		std::vector<std::weak_ptr<Connection>> connections_; /**< Open connections, shut down by `stop()`.*/
+		SolveCache cache_; /**< Solves kept between the batches, used by the batch thread only.*/
+
+		mutable std::mutex stats_mutex_; /**< Protects the statistics.*/
+		std::vector<double> latencies_; /**< Last latencies, in seconds.*/
+		std::size_t next_latency_; /**< Index of the next latency to replace.*/
+		long long requests_; /**< Number of answered requests.*/
+		long long batches_; /**< Number of batches.*/
+		long long solves_; /**< Number of solves.*/
+
+		/**
+		 * @brief Reads the requests of a connection until it is closed.
+		 * @param connection The connection.
+		 */
+		void read_requests(std::shared_ptr<Connection> connection);
+
+		/**
+		 * @brief Parses a line of text into a request.
+		 *
+		 * @param line The line, without its end of line.
+		 * @param request The request, whose error is set if the line is malformed.
+		 */
+		void parse_line(const std::string& line, Request& request) const;
+
+		/**
+		 * @brief Processes the queued requests by batches until the server is stopped.
+		 */
+		void process_batches();
+
+		/**
+		 * @brief Answers a request and records its latency.
+		 *
+		 * @param request The request, whose contract has been given to the cache.
+		 */
+		void answer(const Request& request);
+
+	public:
+
+		/**
+		 * @brief Constructs a Server object, the socket being created by `run()`.
+		 *
+		 * @param path Path of the socket, replaced if it exists.
+		 * @param window Waiting time for the requests of a batch, in seconds.
+		 * @param cache_size Maximum number of solves kept between the batches.
+		 *
+		 * @throws std::invalid_argument If `path` is empty or too long, or if `window` is negative.
+		 */
+		Server(const std::string& path, double window = 1e-4, std::size_t cache_size = 256);
+
+		/**
+		 * @brief Stops the server if it is running, waiting for the end of the reader threads.
+		 *
+		 * The thread calling `run()` must have returned before the destruction.
+		 */
+		~Server();
+
+		Server(const Server&) = delete;
+		Server& operator=(const Server&) = delete;
+
+		/**
+		 * @brief Listens on the socket and answers the requests until `stop()` is called.
+		 *
+		 * @throws std::runtime_error If the socket can not be created, or if Unix-domain
+		 * sockets are not available on this platform.
+		 */
+		void run();
+
+		/**
+		 * @brief Stops the server, from any thread but the reader threads.
+		 *
+		 * The reading side of the connections is shut down and the call returns once their reader
+		 * threads have ended. `run()` then returns once the queued requests are answered.
+		 */
+		void stop();
+
+		/**
+		 * @brief Sets the number of threads used for the solves of a batch, before `run()`.
+		 * @param threads Number of threads, 0 for the number of hardware threads.
+		 */
+		void set_threads(unsigned int threads);
+
+		/**
+		 * @brief Gets a percentile of the latencies.
+		 * @param q Order of the percentile, in [0, 1].
+		 * @return The latency in seconds, 0 if no request has been answered.
+		 */
+		double get_latency(double q) const;
+
+		/**
+		 * @brief Gets the number of answered requests.
+		 * @return Number of requests.
+		 */
+		long long get_requests() const;
+
+		/**
+		 * @brief Gets the number of batches.
+		 * @return Number of batches.
+		 */
+		long long get_batches() const;
+
+		/**
+		 * @brief Gets the number of solves.
+		 * @return Number of solves, the other requests being answered from a shared or cached solve.
+		 */
+		long long get_solves() const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "solvecache.h"
+#include "profile.h"
+#include "trace.h"
+
+namespace ensiie
+{
+	SolveCache::SolveCache(std::size_t capacity) : capacity_(capacity), threads_(0), solves_(0) {};
+
+	SolveCache::Key SolveCache::key(const Contract& c)
+	{
+		return Key(c.call, c.r, c.sigma, c.T, c.L / c.K, c.M, c.N);
+	}
+
+	void SolveCache::set_threads(unsigned int threads)
+	{
+		threads_ = threads;
+	}
+
+	void SolveCache::solve(const std::vector<Contract>& contracts)
+	{
+		// Emptied when full, before the solves so that they stay available for the quotes
+		if (solved_.size() >= capacity_)
+		{
+			solved_.clear();
+		}
+		failed_.clear();
+
+		// Distinct solves not already cached
+		std::vector<Key> keys;
+		std::vector<const Contract*> firsts;
+		for (const Contract& c : contracts)
+		{
+			if (c.K <= 0)
+			{
+				continue;
+			}
+
+			Key k = key(c);
+			if (solved_.count(k) == 0 && std::find(keys.begin(), keys.end(), k) == keys.end())
+			{
+				keys.push_back(k);
+				firsts.push_back(&c);
+			}
+		}
+
+		int n = (int)keys.size();
+		std::vector<std::shared_ptr<const Evaluator>> solved(n);
+		std::vector<std::string> errors(n);
+		unsigned int n_threads = threads_ ? threads_ : std::max(1u, std::thread::hardware_concurrency());
+		n_threads = std::min(n_threads, (unsigned int)std::max(n, 1));
+
+		std::vector<std::thread> threads;
+		for (unsigned int p = 0; p < n_threads; p++)
+		{
+			threads.emplace_back([&, p]()
+			{
+				for (int k = p; k < n; k += n_threads)
+				{
+					const Contract& c = *firsts[k];
+					Trace::Scope trace("solve", "solvecache", (long long)(firsts[k] - contracts.data()), c.call ? "call" : "put", c.N, c.M);
+					try
+					{
+						// Unit strike, the domain being scaled by the strike
+						Data d(c.T, c.r, c.sigma, 1, c.L / c.K, c.M, c.N);
+						if (c.call)
+						{
+							CompleteCall e(d);
+							e.set_threads(1);
+							e.pricing();
+							solved[k] = std::make_shared<const Evaluator>(e);
+						}
+						else
+						{
+							CompletePut e(d);
+							e.set_threads(1);
+							e.pricing();
+							solved[k] = std::make_shared<const Evaluator>(e);
+						}
+					}
+					catch (const std::exception& e)
+					{
+						errors[k] = e.what();
+					}
+				}
+			});
+		}
+
+		for (auto& th : threads)
+		{
+			th.join();
+		}
+
+		for (int k = 0; k < n; k++)
+		{
+			if (solved[k])
+			{
+				solved_[keys[k]] = solved[k];
+			}
+			else
+			{
+				failed_[keys[k]] = errors[k];
+			}
+		}
+		solves_ += n;
+	}
+
+	bool SolveCache::quote(const Contract& c, double values[3], std::string& error) const
+	{
+		ENSIIE_PROFILE_SCOPE(extraction, 1);
+
+		if (c.K <= 0)
+		{
+			error = "K must be positive";
+			return false;
+		}
+
+		Key k = key(c);
+		auto failed = failed_.find(k);
+		if (failed != failed_.end())
+		{
+			error = failed->second;
+			return false;
+		}
+
+		auto solved = solved_.find(k);
+		if (solved == solved_.end())
+		{
+			error = "the contract has not been solved";
+			return false;
+		}
+
+		// Prices of the unit strike solve, at the spot price S / K
+		double x = c.S / c.K;
+		if (x < 0 || x > c.L / c.K)
+		{
+			error = "S must be between 0 and L";
+			return false;
+		}
+
+		values[0] = c.K * solved->second->price(x);
+		values[1] = solved->second->delta(x);
+		values[2] = solved->second->gamma(x) / c.K;
+		return true;
+	}
+
+	long long SolveCache::get_solves() const
+	{
+		return solves_;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+#include "completecall.h"
+#include "completeput.h"
+#include "evaluator.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace ensiie
+{
+	/**
+	 * @struct Contract
+	 * @brief European option to price at a spot price, with the grid of its solve.
+	 */
+	struct Contract
+	{
+		bool call; /**< True for a call option, false for a put option.*/
+		double T; /**< Time to maturity.*/
+		double r; /**< Market risk-free interest rate.*/
+		double sigma; /**< Underlying asset volatility.*/
+		double K; /**< Strike price.*/
+		double L; /**< Maximum asset price of the grid.*/
+		double M; /**< Number of time steps.*/
+		double N; /**< Number of asset price steps.*/
+		double S; /**< Spot price.*/
+	};
+
+	/**
+	 * @class SolveCache
+	 * @brief A class to price many contracts with as few `Complete` solves as possible.
+	 *
+	 * @details
+	 * The prices being homogeneous in (S, K, L), V(S, K, L) = K V(S / K, 1, L / K), the contracts
+	 * sharing the option type, r, sigma, T, L / K and the numbers of steps share one solve with
+	 * unit strike, whatever their strike and spot. `solve()` runs the distinct solves missing
+	 * from the cache in parallel, and `quote()` then reads each contract from the `Evaluator`
+	 * of its solve. The cache is emptied when it is full.
+	 */
+	class SolveCache
+	{
+		typedef std::tuple<bool, double, double, double, double, double, double> Key; /**< Option type, r, sigma, T, L / K, M and N of a solve.*/
+
+		std::size_t capacity_; /**< Maximum number of solves kept.*/
+		unsigned int threads_; /**< Number of threads, 0 for the number of hardware threads.*/
+		std::map<Key, std::shared_ptr<const Evaluator>> solved_; /**< Solves kept between the calls.*/
+		std::map<Key, std::string> failed_; /**< Errors of the solves of the last call of `solve()`.*/
+		long long solves_; /**< Number of solves.*/
+
+		/**
+		 * @brief Gets the solve of a contract.
+		 * @param c The contract.
+		 * @return The key of the solve.
+		 */
+		static Key key(const Contract& c);
+
+	public:
+
+		/**
+		 * @brief Constructs an empty SolveCache object.
+		 * @param capacity Maximum number of solves kept between the calls of `solve()`.
+		 */
+		explicit SolveCache(std::size_t capacity = 256);
+
+		/**
+		 * @brief Sets the number of threads used for the solves.
+		 * @param threads Number of threads, 0 for the number of hardware threads.
+		 */
+		void set_threads(unsigned int threads);
+
+		/**
+		 * @brief Runs the solves of a set of contracts which are not in the cache.
+		 *
+		 * The solves are kept at least until the next call, so that all the contracts can be
+		 * quoted. An invalid contract is not an error here, it is reported by `quote()`.
+		 *
+		 * @param contracts The contracts.
+		 */
+		void solve(const std::vector<Contract>& contracts);
+
+		/**
+		 * @brief Computes the price, the delta and the gamma of a contract given to the last `solve()`.
+		 *
+		 * @param c The contract.
+		 * @param values Array overwritten with the price, the delta and the gamma.
+		 * @param error Overwritten with the error if the contract can not be priced.
+		 * @return True if the contract is priced, false otherwise.
+		 */
+		bool quote(const Contract& c, double values[3], std::string& error) const;
+
+		/**
+		 * @brief Gets the number of solves.
+		 * @return Number of solves since the construction.
+		 */
+		long long get_solves() const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,253 @@
+// 64-bit off_t for fseeko() on the 32-bit POSIX systems, before any system header
+#define _FILE_OFFSET_BITS 64
+#include "surface.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ENSIIE_MMAP
+#endif
+
+namespace ensiie
+{
+	static const char surface_magic[8] = { 'B', 'S', 'P', 'D', 'E', 'S', 'R', 'F' };
+	static const std::uint32_t surface_byte_order = 0x01020304;
+
+	// Seek with a 64-bit offset, fseek() taking a long, which is 32 bits on LLP64 systems
+	static int seek(std::FILE* file, std::uint64_t offset)
+	{
+#if defined(_WIN32)
+		return _fseeki64(file, (__int64)offset, SEEK_SET);
+#else
+		return fseeko(file, (off_t)offset, SEEK_SET);
+#endif
+	}
+
+	SurfaceWriter::SurfaceWriter(const std::string& path, const Data& d) : file_(nullptr)
+	{
+		std::uint64_t layers = (std::uint64_t)d.get_M() + 1;
+		std::uint64_t nodes = (std::uint64_t)d.get_N() + 1;
+
+		std::memset(&header_, 0, sizeof(header_));
+		std::memcpy(header_.magic, surface_magic, sizeof(surface_magic));
+		header_.version = version;
+		header_.byte_order = surface_byte_order;
+		header_.header_size = sizeof(SurfaceHeader);
+		header_.layers = layers;
+		header_.nodes = nodes;
+		header_.t_offset = sizeof(SurfaceHeader);
+		header_.l_offset = header_.t_offset + layers * sizeof(double);
+		header_.data_offset = (header_.l_offset + nodes * sizeof(double) + 63) / 64 * 64;
+		header_.T = d.get_T();
+		header_.r = d.get_r();
+		header_.sigma = d.get_sigma();
+		header_.K = d.get_K();
+		header_.L = d.get_L();
+
+		file_ = std::fopen(path.c_str(), "wb");
+		if (!file_)
+		{
+			throw std::runtime_error("The surface file " + path + " can not be created");
+		}
+
+		// Header marked incomplete, then the grids and the padding up to the first layer
+		std::vector<char> padding(header_.data_offset - header_.l_offset - nodes * sizeof(double), 0);
+		bool ok = std::fwrite(&header_, sizeof(header_), 1, file_) == 1;
+		ok = ok && std::fwrite(d.get_t().data(), sizeof(double), layers, file_) == layers;
+		ok = ok && std::fwrite(d.get_l().data(), sizeof(double), nodes, file_) == nodes;
+		ok = ok && std::fwrite(padding.data(), 1, padding.size(), file_) == padding.size();
+		if (!ok)
+		{
+			std::fclose(file_);
+			file_ = nullptr;
+			throw std::runtime_error("The surface file " + path + " can not be written");
+		}
+
+		done_.assign(layers, false);
+	}
+
+	SurfaceWriter::~SurfaceWriter()
+	{
+		try
+		{
+			close();
+		}
+		catch (const std::exception&)
+		{
+		}
+	}
+
+	void SurfaceWriter::write_layer(int i, const std::vector<double>& v)
+	{
+		if (i < 0 || (std::uint64_t)i >= header_.layers || v.size() != header_.nodes)
+		{
+			throw std::invalid_argument("The layer must have a time index in [0, M] and N+1 prices");
+		}
+		if (!file_)
+		{
+			throw std::runtime_error("The surface file is closed");
+		}
+
+		std::uint64_t offset = header_.data_offset + i * header_.nodes * sizeof(double);
+		if (seek(file_, offset) != 0 || std::fwrite(v.data(), sizeof(double), v.size(), file_) != v.size())
+		{
+			throw std::runtime_error("The surface file can not be written");
+		}
+
+		if (!done_[i])
+		{
+			done_[i] = true;
+			header_.written++;
+		}
+	}
+
+	void SurfaceWriter::close()
+	{
+		if (!file_)
+		{
+			return;
+		}
+
+		// The header is rewritten last, so that a reader never sees a partial surface as complete
+		header_.complete = (header_.written == header_.layers) ? 1 : 0;
+		bool ok = std::fflush(file_) == 0;
+		ok = ok && seek(file_, 0) == 0;
+		ok = ok && std::fwrite(&header_, sizeof(header_), 1, file_) == 1;
+		ok = (std::fclose(file_) == 0) && ok;
+		file_ = nullptr;
+
+		if (!ok)
+		{
+			throw std::runtime_error("The surface file can not be written");
+		}
+	}
+
+	Surface::Surface(const std::string& path) : data_(nullptr), size_(0), mapped_(false), header_(nullptr)
+	{
+#ifdef ENSIIE_MMAP
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			throw std::runtime_error("The surface file " + path + " can not be opened");
+		}
+
+		struct stat info;
+		if (fstat(fd, &info) == 0 && info.st_size > 0)
+		{
+			void* address = mmap(nullptr, (std::size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (address != MAP_FAILED)
+			{
+				data_ = (const unsigned char*)address;
+				size_ = (std::size_t)info.st_size;
+				mapped_ = true;
+			}
+		}
+		::close(fd);
+#endif
+
+		// Copy of the file when it can not be mapped
+		if (!mapped_)
+		{
+			std::ifstream in(path, std::ios::binary);
+			if (!in)
+			{
+				throw std::runtime_error("The surface file " + path + " can not be opened");
+			}
+			copy_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+			data_ = copy_.data();
+			size_ = copy_.size();
+		}
+
+		header_ = (const SurfaceHeader*)data_;
+
+		std::string error;
+		if (size_ < sizeof(SurfaceHeader) || std::memcmp(header_->magic, surface_magic, sizeof(surface_magic)) != 0)
+		{
+			error = "is not a surface file";
+		}
+		else if (header_->byte_order != surface_byte_order)
+		{
+			error = "was written with another byte order";
+		}
+		else if (header_->version != SurfaceWriter::version || header_->header_size != sizeof(SurfaceHeader))
+		{
+			error = "has an unknown version";
+		}
+		else if (!header_->complete || header_->layers < 2 || header_->nodes < 2 || header_->data_offset % sizeof(double) != 0
+			|| header_->data_offset + header_->layers * header_->nodes * sizeof(double) > size_)
+		{
+			error = "is incomplete";
+		}
+
+		if (!error.empty())
+		{
+#ifdef ENSIIE_MMAP
+			if (mapped_)
+			{
+				munmap((void*)data_, size_);
+			}
+#endif
+			throw std::runtime_error("The surface file " + path + " " + error);
+		}
+	}
+
+	Surface::~Surface()
+	{
+#ifdef ENSIIE_MMAP
+		if (mapped_)
+		{
+			munmap((void*)data_, size_);
+			mapped_ = false;
+		}
+#endif
+	}
+
+	const SurfaceHeader& Surface::get_header() const
+	{
+		return *header_;
+	}
+
+	Span Surface::get_t() const
+	{
+		return Span((const double*)(data_ + header_->t_offset), header_->layers);
+	}
+
+	Span Surface::get_l() const
+	{
+		return Span((const double*)(data_ + header_->l_offset), header_->nodes);
+	}
+
+	Span Surface::layer(int i) const
+	{
+		if (i < 0 || (std::uint64_t)i >= header_->layers)
+		{
+			throw std::invalid_argument("The time index must be in [0, M]");
+		}
+
+		return Span((const double*)(data_ + header_->data_offset) + i * header_->nodes, header_->nodes);
+	}
+
+	double Surface::price(int i, double s) const
+	{
+		if (s < 0 || s > header_->L)
+		{
+			throw std::invalid_argument("The spot price must be in [0, L]");
+		}
+
+		Span v = layer(i);
+		Span l = get_l();
+
+		// Interval of the grid containing s, the grid being evenly spaced from l_0
+		std::size_t n = l.size() - 1;
+		double x = (s - l[0]) / (l[n] - l[0]) * n;
+		std::size_t j = std::min((std::size_t)std::max(x, 0.0), n - 1);
+
+		double w = x - j;
+		return (1 - w) * v[j] + w * v[j + 1];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,178 @@
+#pragma once
+#include "data.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace ensiie
+{
+	/**
+	 * @struct SurfaceHeader
+	 * @brief Header of a surface file, at its beginning.
+	 *
+	 * @details
+	 * A surface file holds the prices V(t_i, s_j) of a solve. After the header come the time
+	 * grid t (M+1 doubles), the asset price grid l (N+1 doubles), then the layers, the layer i
+	 * being the N+1 prices at the time t_i. The layers are contiguous, in increasing order of
+	 * time, and start at an offset multiple of 64 bytes, so that a layer is found at
+	 * `data_offset + i * (N+1) * 8`. All the values are in the byte order of the writer,
+	 * recorded in `byte_order`.
+	 */
+	struct SurfaceHeader
+	{
+		char magic[8]; /**< "BSPDESRF".*/
+		std::uint32_t version; /**< Version of the format.*/
+		std::uint32_t byte_order; /**< 0x01020304 in the byte order of the writer.*/
+		std::uint32_t header_size; /**< Size of the header, in bytes.*/
+		std::uint32_t complete; /**< 1 once all the layers are written, 0 before.*/
+		std::uint64_t layers; /**< Number of layers, M+1.*/
+		std::uint64_t nodes; /**< Number of prices of a layer, N+1.*/
+		std::uint64_t t_offset; /**< Offset of the time grid, in bytes.*/
+		std::uint64_t l_offset; /**< Offset of the asset price grid, in bytes.*/
+		std::uint64_t data_offset; /**< Offset of the first layer, in bytes.*/
+		std::uint64_t written; /**< Number of layers written.*/
+		double T; /**< Time to maturity.*/
+		double r; /**< Market risk-free interest rate.*/
+		double sigma; /**< Underlying asset volatility.*/
+		double K; /**< Strike price of the option.*/
+		double L; /**< Underlying asset maximum price.*/
+		char reserved[16]; /**< Zero, for the next versions.*/
+	};
+
+	static_assert(sizeof(SurfaceHeader) == 128, "The surface header must be 128 bytes long");
+
+	/**
+	 * @class SurfaceWriter
+	 * @brief A class to write the price surface of a solve, layer after layer.
+	 *
+	 * @details
+	 * The header and the grids are written on construction. The engines given the writer
+	 * with `set_surface()` then write each layer as soon as it is computed, in the order of
+	 * their backward sweep, at its place in the file. The header is marked complete by
+	 * `close()` once all the layers are written.
+	 */
+	class SurfaceWriter
+	{
+		std::FILE* file_; /**< Output file, null once closed.*/
+		SurfaceHeader header_; /**< Header of the file.*/
+		std::vector<bool> done_; /**< Layers already written.*/
+
+	public:
+
+		static const std::uint32_t version = 1; /**< Version of the format written.*/
+
+		/**
+		 * @brief Creates a surface file for the grid of a Data object.
+		 *
+		 * @param path Path of the file, replaced if it exists.
+		 * @param d A `Data` object containing the parameters and the grid of the solve.
+		 *
+		 * @throws std::runtime_error If the file can not be written.
+		 */
+		SurfaceWriter(const std::string& path, const Data& d);
+
+		/**
+		 * @brief Closes the file if needed.
+		 */
+		~SurfaceWriter();
+
+		SurfaceWriter(const SurfaceWriter&) = delete;
+		SurfaceWriter& operator=(const SurfaceWriter&) = delete;
+
+		/**
+		 * @brief Writes a layer.
+		 *
+		 * @param i Time index of the layer, in [0, M].
+		 * @param v Prices at the time t_i, of size N+1.
+		 *
+		 * @throws std::invalid_argument If `i` or the size of `v` is out of range.
+		 * @throws std::runtime_error If the file can not be written.
+		 */
+		void write_layer(int i, const std::vector<double>& v);
+
+		/**
+		 * @brief Marks the file complete if all the layers are written, then closes it.
+		 *
+		 * @throws std::runtime_error If the file can not be written.
+		 */
+		void close();
+	};
+
+	/**
+	 * @class Surface
+	 * @brief A read-only view over a surface file, mapped in memory.
+	 *
+	 * @details
+	 * The file is mapped with `mmap()`, so that the layers are read without copy nor parsing,
+	 * and the pages are shared by all the processes reading the same file. On the systems
+	 * without `mmap()`, the file is read into memory instead.
+	 */
+	class Surface
+	{
+		const unsigned char* data_; /**< First byte of the file.*/
+		std::size_t size_; /**< Size of the file, in bytes.*/
+		bool mapped_; /**< True if the file is mapped, false if it is read.*/
+		std::vector<unsigned char> copy_; /**< Content of the file when it is read.*/
+		const SurfaceHeader* header_; /**< Header of the file.*/
+
+	public:
+
+		/**
+		 * @brief Opens a surface file.
+		 *
+		 * @param path Path of the file.
+		 *
+		 * @throws std::runtime_error If the file can not be read, is not a complete surface file
+		 * of a known version, or was written with another byte order.
+		 */
+		explicit Surface(const std::string& path);
+
+		/**
+		 * @brief Unmaps the file.
+		 */
+		~Surface();
+
+		Surface(const Surface&) = delete;
+		Surface& operator=(const Surface&) = delete;
+
+		/**
+		 * @brief Gets the header of the file.
+		 * @return The header, with the parameters of the solve.
+		 */
+		const SurfaceHeader& get_header() const;
+
+		/**
+		 * @brief Gets the time grid.
+		 * @return A view over the M+1 times.
+		 */
+		Span get_t() const;
+
+		/**
+		 * @brief Gets the asset price grid.
+		 * @return A view over the N+1 asset prices.
+		 */
+		Span get_l() const;
+
+		/**
+		 * @brief Gets a layer.
+		 *
+		 * @param i Time index, in [0, M].
+		 * @return A view over the N+1 prices at the time t_i.
+		 * @throws std::invalid_argument If `i` is out of range.
+		 */
+		Span layer(int i) const;
+
+		/**
+		 * @brief Gets the price at a time index and a spot price, by linear interpolation.
+		 *
+		 * The asset price grid being evenly spaced, the interval containing `s` is found in
+		 * constant time.
+		 *
+		 * @param i Time index, in [0, M].
+		 * @param s Spot price, in [0, L].
+		 * @return The interpolated price.
+		 * @throws std::invalid_argument If `i` or `s` is out of range.
+		 */
+		double price(int i, double s) const;
+	};
+}
\ No newline at end of file
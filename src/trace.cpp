@@ -0,0 +1,236 @@
+#include "trace.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace ensiie
+{
+	/**
+	 * @brief Complete event, the times being in nanoseconds since the start of the trace.
+	 */
+	struct TraceEvent
+	{
+		const char* name;
+		const char* category;
+		const char* engine;
+		long long id;
+		double N;
+		double M;
+		long long start;
+		long long duration;
+	};
+
+	/**
+	 * @brief Events of a thread, appended by the thread only.
+	 */
+	struct TraceBuffer
+	{
+		std::vector<TraceEvent> events;
+		long long dropped = 0;
+		bool in_use = false; /**< True while a thread appends to the buffer, under the registry lock.*/
+	};
+
+	/**
+	 * @brief Buffers of all the threads, never freed so that the threads may end after the program.
+	 */
+	struct TraceRegistry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<TraceBuffer>> buffers;
+		std::atomic<bool> active{ false };
+		std::size_t capacity = 0;
+		std::chrono::steady_clock::time_point epoch;
+	};
+
+	static TraceRegistry& registry()
+	{
+		static TraceRegistry* r = new TraceRegistry();
+		return *r;
+	}
+
+	/**
+	 * @brief Buffer held by a thread during its lifetime.
+	 */
+	struct TraceSlot
+	{
+		TraceBuffer* buffer;
+
+		TraceSlot() : buffer(nullptr)
+		{
+			TraceRegistry& r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			for (auto& b : r.buffers)
+			{
+				if (!b->in_use)
+				{
+					buffer = b.get();
+					break;
+				}
+			}
+			if (!buffer)
+			{
+				r.buffers.push_back(std::make_unique<TraceBuffer>());
+				buffer = r.buffers.back().get();
+			}
+			buffer->in_use = true;
+		}
+
+		~TraceSlot()
+		{
+			std::lock_guard<std::mutex> lock(registry().mutex);
+			buffer->in_use = false;
+		}
+	};
+
+	/**
+	 * @brief Contract id of the innermost scope of the thread.
+	 */
+	static thread_local long long trace_id = -1;
+
+	Trace::Scope::Scope(const char* name, const char* category, long long id, const char* engine, double N, double M)
+		: active_(registry().active.load(std::memory_order_relaxed)), name_(name), category_(category), engine_(engine), id_(id), previous_id_(trace_id), N_(N), M_(M)
+	{
+		if (!active_)
+		{
+			return;
+		}
+		if (id_ < 0)
+		{
+			id_ = trace_id;
+		}
+		trace_id = id_;
+		start_ = std::chrono::steady_clock::now();
+	}
+
+	Trace::Scope::~Scope()
+	{
+		if (!active_)
+		{
+			return;
+		}
+
+		auto end = std::chrono::steady_clock::now();
+		trace_id = previous_id_;
+
+		thread_local TraceSlot slot;
+		TraceRegistry& r = registry();
+		TraceBuffer& b = *slot.buffer;
+		if (b.events.size() >= r.capacity)
+		{
+			b.dropped++;
+			return;
+		}
+
+		long long start = std::chrono::duration_cast<std::chrono::nanoseconds>(start_ - r.epoch).count();
+		long long duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count();
+		b.events.push_back(TraceEvent{ name_, category_, engine_, id_, N_, M_, start, duration });
+	}
+
+	void Trace::start(std::size_t capacity)
+	{
+		TraceRegistry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		for (auto& b : r.buffers)
+		{
+			b->events.clear();
+			b->dropped = 0;
+		}
+		r.capacity = capacity;
+		r.epoch = std::chrono::steady_clock::now();
+		r.active = true;
+	}
+
+	void Trace::stop()
+	{
+		registry().active = false;
+	}
+
+	bool Trace::active()
+	{
+		return registry().active;
+	}
+
+	/**
+	 * @brief Readable name of an engine type, demangled when it comes from `typeid`.
+	 */
+	static std::string engine_name(const char* engine)
+	{
+		std::string name = engine;
+#if defined(__GNUG__)
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(engine, nullptr, nullptr, &status);
+		if (status == 0 && demangled)
+		{
+			name = demangled;
+		}
+		std::free(demangled);
+#endif
+		return name;
+	}
+
+	void Trace::write(std::ostream& out)
+	{
+		TraceRegistry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+
+		char line[512];
+		bool first = true;
+		out << "{\"traceEvents\":[";
+
+		for (std::size_t tid = 0; tid < r.buffers.size(); tid++)
+		{
+			const TraceBuffer& b = *r.buffers[tid];
+
+			// Name of the track, the buffers being reused by the successive threads
+			std::snprintf(line, sizeof(line), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"thread %zu\"}}",
+				first ? "" : ",", tid, tid);
+			out << line;
+			first = false;
+
+			for (const TraceEvent& e : b.events)
+			{
+				std::snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%zu,\"args\":{",
+					e.name, e.category, e.start * 1e-3, e.duration * 1e-3, tid);
+				out << line;
+
+				std::string args;
+				if (e.id >= 0)
+				{
+					args += ",\"id\":" + std::to_string(e.id);
+				}
+				if (e.engine)
+				{
+					args += ",\"engine\":\"" + engine_name(e.engine) + "\"";
+				}
+				if (e.N > 0)
+				{
+					std::snprintf(line, sizeof(line), ",\"N\":%.0f,\"M\":%.0f", e.N, e.M);
+					args += line;
+				}
+				out << (args.empty() ? "" : args.c_str() + 1) << "}}";
+			}
+		}
+
+		out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	}
+
+	long long Trace::get_dropped()
+	{
+		TraceRegistry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		long long dropped = 0;
+		for (auto& b : r.buffers)
+		{
+			dropped += b->dropped;
+		}
+		return dropped;
+	}
+}
\ No newline at end of file
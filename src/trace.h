@@ -0,0 +1,102 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+namespace ensiie
+{
+	/**
+	 * @class Trace
+	 * @brief A timeline of the solves, exported in the Chrome trace format.
+	 *
+	 * @details
+	 * While the trace is active, each `Trace::Scope` records a complete event: its name and
+	 * category, the start and the duration, the contract id, the engine and the grid size.
+	 * The engines record their sweeps and the parallel drivers their solves and stages, so
+	 * that the scheduling gaps and the stragglers of a run show in a trace viewer such as
+	 * Perfetto or chrome://tracing, one track per thread.
+	 *
+	 * Each thread appends to its own buffer, without locking nor atomic read-modify-write,
+	 * the buffer of a finished thread being reused by the next one. A scope built while the
+	 * trace is inactive only reads a flag. The contract id of a scope is inherited by the
+	 * scopes nested in it, so that the sweep of an engine carries the id of the contract the
+	 * driver is solving.
+	 */
+	class Trace
+	{
+	public:
+
+		/**
+		 * @class Scope
+		 * @brief Event of the timeline, from its construction to its destruction.
+		 */
+		class Scope
+		{
+			bool active_; /**< True if the event is recorded.*/
+			const char* name_; /**< Name of the event.*/
+			const char* category_; /**< Category of the event.*/
+			const char* engine_; /**< Engine type, null if none.*/
+			long long id_; /**< Contract id, -1 if none.*/
+			long long previous_id_; /**< Contract id of the enclosing scope.*/
+			double N_; /**< Number of asset price steps, 0 if none.*/
+			double M_; /**< Number of time steps, 0 if none.*/
+			std::chrono::steady_clock::time_point start_; /**< Start of the event.*/
+
+		public:
+
+			/**
+			 * @brief Starts an event, if the trace is active.
+			 *
+			 * @param name Name of the event, a string literal.
+			 * @param category Category of the event, a string literal.
+			 * @param id Contract id, -1 to inherit the one of the enclosing scope.
+			 * @param engine Engine type, a string literal or a `typeid` name, null if none.
+			 * @param N Number of asset price steps, 0 if none.
+			 * @param M Number of time steps, 0 if none.
+			 */
+			Scope(const char* name, const char* category, long long id = -1, const char* engine = nullptr, double N = 0, double M = 0);
+
+			/**
+			 * @brief Ends the event and appends it to the buffer of the thread.
+			 */
+			~Scope();
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		};
+
+		/**
+		 * @brief Clears the buffers and starts recording, while no traced code runs.
+		 *
+		 * @param capacity Maximum number of events of each thread buffer, the next ones being dropped.
+		 */
+		static void start(std::size_t capacity = 1 << 20);
+
+		/**
+		 * @brief Stops recording.
+		 */
+		static void stop();
+
+		/**
+		 * @brief Tells whether the trace is recording.
+		 * @return True between `start()` and `stop()`.
+		 */
+		static bool active();
+
+		/**
+		 * @brief Writes the recorded events as a Chrome trace JSON document.
+		 *
+		 * The events are read without locking, so the threads recording them must have
+		 * finished, or the trace must be stopped.
+		 *
+		 * @param out Output stream.
+		 */
+		static void write(std::ostream& out);
+
+		/**
+		 * @brief Gets the number of events dropped because a buffer was full.
+		 * @return Number of dropped events.
+		 */
+		static long long get_dropped();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "vmath.h"
+#include <cstdint>
+#include <cstring>
+
+namespace ensiie
+{
+	// The comparisons are made on the bits of the values, as integers: a floating point
+	// comparison may raise an exception, which prevents the compiler from vectorizing it.
+
+	void vector_exp(const double* x, double* y, std::size_t n)
+	{
+		const double log2e = 1.4426950408889634;
+		const double ln2_hi = 6.93147180369123816490e-01;
+		const double ln2_lo = 1.90821492927058770002e-10;
+		const double shifter = 6755399441055744.0; // 1.5 * 2^52, rounds to the nearest integer
+		const std::int64_t shifter_bits = 0x4338000000000000ll;
+		const std::uint64_t low_bits = 0xC086200000000000ull; // -708
+		const std::int64_t high_bits = 0x4086280000000000ll; // 709
+		const std::int64_t infinity_bits = 0x7FF0000000000000ll;
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			// Clamp to [-708, 709], where the result is a normal number
+			std::int64_t bits;
+			std::memcpy(&bits, &x[i], sizeof(bits));
+			bool underflow = (std::uint64_t)bits > low_bits;
+			bool overflow = bits > high_bits;
+			bits = underflow ? (std::int64_t)low_bits : bits;
+			bits = overflow ? high_bits : bits;
+			double c;
+			std::memcpy(&c, &bits, sizeof(c));
+
+			// Reduction x = k ln(2) + r
+			double shifted = c * log2e + shifter;
+			double k = shifted - shifter;
+			double r = (c - k * ln2_hi) - k * ln2_lo;
+
+			// e^r by its Taylor polynomial, in Horner form
+			double p = 1.0 / 479001600;
+			p = p * r + 1.0 / 39916800;
+			p = p * r + 1.0 / 3628800;
+			p = p * r + 1.0 / 362880;
+			p = p * r + 1.0 / 40320;
+			p = p * r + 1.0 / 5040;
+			p = p * r + 1.0 / 720;
+			p = p * r + 1.0 / 120;
+			p = p * r + 1.0 / 24;
+			p = p * r + 1.0 / 6;
+			p = p * r + 0.5;
+			p = p * r + 1.0;
+			p = p * r + 1.0;
+
+			// 2^k from the bits of the exponent, k being the low bits of the shifted value
+			std::int64_t scale_bits;
+			std::memcpy(&scale_bits, &shifted, sizeof(scale_bits));
+			scale_bits = (scale_bits - shifter_bits + 1023) << 52;
+			double scale;
+			std::memcpy(&scale, &scale_bits, sizeof(scale));
+
+			double e = p * scale;
+			std::int64_t e_bits;
+			std::memcpy(&e_bits, &e, sizeof(e_bits));
+			e_bits = underflow ? 0 : e_bits;
+			e_bits = overflow ? infinity_bits : e_bits;
+			std::memcpy(&y[i], &e_bits, sizeof(e_bits));
+		}
+	}
+
+	void vector_log(const double* x, double* y, std::size_t n)
+	{
+		const double ln2_hi = 6.93147180369123816490e-01;
+		const double ln2_lo = 1.90821492927058770002e-10;
+		const std::uint64_t sqrt2_bits = 0x3FF6A09E667F3BCDull; // sqrt(2)
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			// Split x = m 2^e with m in [1, 2)
+			std::uint64_t bits;
+			std::memcpy(&bits, &x[i], sizeof(bits));
+			std::uint64_t mantissa = (bits & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
+			std::uint64_t biased = bits >> 52;
+
+			// Then m in [sqrt(2)/2, sqrt(2)), halving m by its exponent
+			bool high = mantissa > sqrt2_bits;
+			mantissa = high ? mantissa - (1ull << 52) : mantissa;
+			biased = high ? biased + 1 : biased;
+			double m;
+			std::memcpy(&m, &mantissa, sizeof(m));
+
+			// Exponent as a double, 2^52 + b having b as low bits
+			biased |= 0x4330000000000000ull;
+			double k;
+			std::memcpy(&k, &biased, sizeof(k));
+			k -= 4503599627370496.0 + 1023;
+
+			// log(m) = 2 atanh(s), s = (m - 1) / (m + 1), |s| <= 0.1716
+			double s = (m - 1) / (m + 1);
+			double s2 = s * s;
+			double p = 2.0 / 25;
+			p = p * s2 + 2.0 / 23;
+			p = p * s2 + 2.0 / 21;
+			p = p * s2 + 2.0 / 19;
+			p = p * s2 + 2.0 / 17;
+			p = p * s2 + 2.0 / 15;
+			p = p * s2 + 2.0 / 13;
+			p = p * s2 + 2.0 / 11;
+			p = p * s2 + 2.0 / 9;
+			p = p * s2 + 2.0 / 7;
+			p = p * s2 + 2.0 / 5;
+			p = p * s2 + 2.0 / 3;
+
+			y[i] = k * ln2_hi + ((2 * s + s * s2 * p) + k * ln2_lo);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+
+namespace ensiie
+{
+	/**
+	 * @brief Computes the exponential of each value of an array.
+	 *
+	 * @details
+	 * The argument is reduced to x = k ln(2) + r with |r| <= ln(2)/2, e^r is evaluated by a
+	 * polynomial of degree 12 and 2^k is built from the bits of the exponent. The loop has
+	 * no branch and no call, so the compiler vectorizes it. The error is at most 3 ulp for
+	 * x in [-708, 709]; below, the result is 0, and above, infinity.
+	 *
+	 * @param x Array of arguments.
+	 * @param y Array of results, which may be the array of arguments.
+	 * @param n Number of values.
+	 */
+	void vector_exp(const double* x, double* y, std::size_t n);
+
+	/**
+	 * @brief Computes the natural logarithm of each value of an array.
+	 *
+	 * @details
+	 * The argument is split as x = m 2^e with m in [sqrt(2)/2, sqrt(2)), and
+	 * log(m) = 2 atanh(s) with s = (m - 1) / (m + 1) is evaluated by an odd polynomial in s.
+	 * As for `vector_exp()`, the loop is branch-free and vectorized. The error is at most 2 ulp
+	 * for positive normal numbers, the only supported arguments.
+	 *
+	 * @param x Array of positive arguments.
+	 * @param y Array of results, which may be the array of arguments.
+	 * @param n Number of values.
+	 */
+	void vector_log(const double* x, double* y, std::size_t n);
+}
\ No newline at end of file
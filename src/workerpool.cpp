@@ -0,0 +1,102 @@
+#include "workerpool.h"
+#include <stdexcept>
+
+namespace ensiie
+{
+	WorkerPool::WorkerPool(int threads) : task_(nullptr), context_(nullptr), generation_(0), pending_(0), stop_(false)
+	{
+		if (threads <= 0)
+		{
+			throw std::invalid_argument("The number of threads must be positive");
+		}
+
+		// The started workers are joined if a launch fails, the destructor not being called
+		try
+		{
+			for (int k = 1; k < threads; k++)
+			{
+				workers_.emplace_back(&WorkerPool::work, this, k);
+			}
+		}
+		catch (...)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				stop_ = true;
+			}
+			start_.notify_all();
+			for (auto& worker : workers_)
+			{
+				worker.join();
+			}
+			throw;
+		}
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		start_.notify_all();
+
+		for (auto& worker : workers_)
+		{
+			worker.join();
+		}
+	}
+
+	int WorkerPool::size() const
+	{
+		return (int)workers_.size() + 1;
+	}
+
+	void WorkerPool::work(int k)
+	{
+		unsigned long seen = 0;
+
+		while (true)
+		{
+			void (*task)(void*, int);
+			void* context;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				start_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+				if (stop_)
+				{
+					return;
+				}
+				seen = generation_;
+				task = task_;
+				context = context_;
+			}
+
+			task(context, k);
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (--pending_ == 0)
+			{
+				done_.notify_one();
+			}
+		}
+	}
+
+	void WorkerPool::dispatch(void (*task)(void*, int), void* context)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			task_ = task;
+			context_ = context;
+			pending_ = (int)workers_.size();
+			generation_++;
+		}
+		start_.notify_all();
+
+		// The calling thread takes the index 0, then waits for the workers
+		task(context, 0);
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		done_.wait(lock, [this]() { return pending_ == 0; });
+	}
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+
+namespace ensiie
+{
+	/**
+	 * @class WorkerPool
+	 * @brief A class to run the phases of a parallel algorithm on threads started once.
+	 *
+	 * @details
+	 * The pool starts `threads - 1` worker threads at its construction, the calling thread being
+	 * the thread 0. `run()` calls a task with the index of each thread and returns once all of
+	 * them have finished, so successive calls are separated by a barrier. The task is passed by
+	 * address, without any copy, so a call does not allocate memory.
+	 *
+	 * The tasks must not throw, and `run()` must only be called by the thread which constructed
+	 * the pool.
+	 */
+	class WorkerPool
+	{
+		std::vector<std::thread> workers_; /**< Worker threads, of index 1 to size() - 1.*/
+		std::mutex mutex_;
+		std::condition_variable start_; /**< Signals a new task or the stop.*/
+		std::condition_variable done_; /**< Signals the end of the task on every worker.*/
+		void (*task_)(void*, int); /**< Current task, called with its context and the index of the thread.*/
+		void* context_; /**< Context of the current task.*/
+		unsigned long generation_; /**< Number of tasks started.*/
+		int pending_; /**< Number of workers still running the current task.*/
+		bool stop_; /**< True once the pool is destroyed.*/
+
+		/**
+		 * @brief Runs the tasks on a worker thread until the stop.
+		 * @param k Index of the thread.
+		 */
+		void work(int k);
+
+		/**
+		 * @brief Runs a task on every thread and waits for its end.
+		 *
+		 * @param task Task, called with `context` and the index of the thread.
+		 * @param context Context of the task.
+		 */
+		void dispatch(void (*task)(void*, int), void* context);
+
+	public:
+
+		/**
+		 * @brief Starts the worker threads.
+		 *
+		 * @param threads Number of threads, including the calling one.
+		 * @throws std::invalid_argument If `threads` is not positive.
+		 * @throws std::system_error If a thread can not be started, the ones already started being joined.
+		 */
+		explicit WorkerPool(int threads);
+
+		/**
+		 * @brief Stops and joins the worker threads.
+		 */
+		~WorkerPool();
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		/**
+		 * @brief Gets the number of threads.
+		 * @return Number of threads, including the calling one.
+		 */
+		int size() const;
+
+		/**
+		 * @brief Calls a task on every thread and waits for all of them.
+		 * @param task Callable with the index of the thread, from 0 for the calling thread to size() - 1.
+		 */
+		template <typename Task>
+		void run(Task&& task)
+		{
+			using Type = std::remove_reference_t<Task>;
+			dispatch([](void* context, int k) { (*static_cast<Type*>(context))(k); }, static_cast<void*>(&task));
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "workspace.h"
+
+namespace ensiie
+{
+	PricingWorkspace::Scope::Scope(PricingWorkspace& workspace) : workspace_(workspace), mark_(workspace.used_) {};
+
+	PricingWorkspace::Scope::~Scope()
+	{
+		workspace_.used_ = mark_;
+	}
+
+	PricingWorkspace::PricingWorkspace() : used_(0) {};
+
+	PricingWorkspace& PricingWorkspace::local()
+	{
+		thread_local PricingWorkspace workspace;
+		return workspace;
+	}
+
+	std::vector<double>& PricingWorkspace::acquire(std::size_t n)
+	{
+		if (used_ == buffers_.size())
+		{
+			buffers_.emplace_back();
+		}
+
+		// The capacity is kept, so no memory is allocated once the buffer has been this long
+		std::vector<double>& buffer = buffers_[used_++];
+		buffer.resize(n);
+
+		return buffer;
+	}
+
+	void PricingWorkspace::clear()
+	{
+		buffers_.resize(used_);
+	}
+
+	std::size_t PricingWorkspace::get_buffers() const
+	{
+		return buffers_.size();
+	}
+
+	std::size_t PricingWorkspace::get_used() const
+	{
+		return used_;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <cstddef>
+
+namespace ensiie
+{
+	/**
+	 * @class PricingWorkspace
+	 * @brief A class to reuse the scratch buffers of the pricing engines between calls.
+	 *
+	 * @details
+	 * The workspace is an arena of vectors: `acquire()` hands out the next buffer, resized to
+	 * the requested length, and a `Scope` gives back all the buffers acquired during its
+	 * lifetime when it is destroyed. The buffers keep their capacity, so once every size has
+	 * been seen, acquiring a buffer does not allocate memory and repeated pricings with the
+	 * same grid run without any heap allocation.
+	 *
+	 * The buffers are kept in a deque, so the references handed out stay valid when new
+	 * buffers are added. Each thread has its own workspace, given by `local()`, and no
+	 * locking is needed.
+	 *
+	 * The content of an acquired buffer is unspecified: it holds whatever its last user left.
+	 */
+	class PricingWorkspace
+	{
+		std::deque<std::vector<double>> buffers_; /**< Buffers of the arena, in the order of acquisition.*/
+		std::size_t used_; /**< Number of buffers currently handed out.*/
+
+	public:
+
+		/**
+		 * @class Scope
+		 * @brief Gives back the buffers acquired during its lifetime.
+		 */
+		class Scope
+		{
+			PricingWorkspace& workspace_;
+			std::size_t mark_;
+
+		public:
+
+			/**
+			 * @brief Records the number of buffers handed out by a workspace.
+			 * @param workspace The workspace the buffers are acquired from.
+			 */
+			explicit Scope(PricingWorkspace& workspace);
+
+			/**
+			 * @brief Gives back the buffers acquired since the construction.
+			 */
+			~Scope();
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		};
+
+		/**
+		 * @brief Constructs an empty workspace.
+		 */
+		PricingWorkspace();
+
+		/**
+		 * @brief Gets the workspace of the calling thread.
+		 * @return A reference to the workspace, created at the first call of each thread.
+		 */
+		static PricingWorkspace& local();
+
+		/**
+		 * @brief Hands out a buffer of a given length.
+		 *
+		 * @param n Length of the buffer.
+		 * @return A reference to the buffer, valid until the enclosing `Scope` is destroyed.
+		 */
+		std::vector<double>& acquire(std::size_t n);
+
+		/**
+		 * @brief Frees the memory of the buffers which are not handed out.
+		 */
+		void clear();
+
+		/**
+		 * @brief Gets the number of buffers of the arena.
+		 * @return Number of buffers, handed out or not.
+		 */
+		std::size_t get_buffers() const;
+
+		/**
+		 * @brief Gets the number of buffers currently handed out.
+		 * @return Number of buffers in use.
+		 */
+		std::size_t get_used() const;
+	};
+}
\ No newline at end of file
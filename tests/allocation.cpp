@@ -0,0 +1,142 @@
+// Test of the steady-state allocations of the pricing engines.
+//
+// The global operator new is replaced by a counting one. Each engine prices twice, so that
+// the workspace of the thread sees every size, then the allocations of the next pricings are
+// counted and must be zero. The only exception is the launch of a std::thread, which allocates
+// its state: the Complete engines are run on one thread, and the Asian call, which launches its
+// threads over the levels of running average, must allocate exactly one state per launch.
+//
+// Build and run from the root of the repository:
+//     g++ -O2 -std=c++17 -pthread -Isrc tests/allocation.cpp $(ls src/*.cpp | grep -v 'main\|sdl') -o test_allocation
+//     ./test_allocation
+// The exit status is 0 when every engine passes.
+
+#include "completecall.h"
+#include "completeput.h"
+#include "completeasiancall.h"
+#include "reducedcall.h"
+#include "reducedput.h"
+#include <iostream>
+#include <string>
+#include <new>
+#include <cstdlib>
+#include <atomic>
+
+namespace
+{
+    std::atomic<long> allocations(0);
+}
+
+void* operator new(std::size_t size)
+{
+    allocations++;
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+using namespace ensiie;
+
+namespace
+{
+    const int warmup = 2;
+    const int repeats = 10;
+
+    // Number of allocations of the repeated pricings, after the warm-up ones
+    template <typename Engine>
+    long steady_allocations(Engine& engine)
+    {
+        for (int k = 0; k < warmup; k++)
+        {
+            engine.pricing();
+        }
+
+        long before = allocations.load();
+        for (int k = 0; k < repeats; k++)
+        {
+            engine.pricing();
+        }
+        return allocations.load() - before;
+    }
+
+    int failures = 0;
+
+    void check(const std::string& name, long count, long expected = 0)
+    {
+        std::cout << (count == expected ? "ok   " : "FAIL ") << name << ": " << count << " allocations in " << repeats << " pricings";
+        if (expected != 0)
+        {
+            std::cout << ", " << expected << " thread launches";
+        }
+        std::cout << '\n';
+        failures += (count != expected);
+    }
+}
+
+int main()
+{
+    Data d(1.0, 0.1, 0.2, 100, 300, 200, 2000);
+
+    CompleteCall complete_call(d);
+    complete_call.set_threads(1);
+    check("CompleteCall", steady_allocations(complete_call));
+
+    CompletePut complete_put(d);
+    complete_put.set_threads(1);
+    check("CompletePut", steady_allocations(complete_put));
+
+    CompleteCall compact(d);
+    compact.set_threads(1);
+    compact.set_compact(true);
+    check("CompleteCall, compact scheme", steady_allocations(compact));
+
+    CompleteCall dividends(d);
+    dividends.set_threads(1);
+    dividends.add_dividend(0.5, 2);
+    check("CompleteCall, cash dividend", steady_allocations(dividends));
+
+    // One launch per thread and per segment between two fixing dates, the one before the first
+    // fixing solving a single level on the calling thread
+    const int fixings = 12;
+    CompleteAsianCall asian(d, fixings, 50);
+    unsigned int level_threads = asian.get_level_threads();
+    long launches = (level_threads > 1) ? (long)repeats * (fixings - 1) * level_threads : 0;
+    check("CompleteAsianCall", steady_allocations(asian), launches);
+
+    ReducedCall reduced_call(d);
+    check("ReducedCall", steady_allocations(reduced_call));
+
+    ReducedPut reduced_put(d);
+    reduced_put.set_scheme_theta(0.5);
+    check("ReducedPut, Crank-Nicolson", steady_allocations(reduced_put));
+
+    std::cout << (failures == 0 ? "All engines price without allocation\n" : "Some engines allocate in steady state\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+// Test of the accuracy of the Fourier-cosine engine.
+//
+// The prices on the grid and on a wide ladder of strikes are compared with the Black-Scholes
+// formula, from a maturity of one year down to one day, where the density of the log-return
+// is narrow against the range of log-moneyness of the grid and of the ladder.
+//
+// Build and run from the root of the repository:
+//     g++ -O2 -std=c++17 -pthread -Isrc tests/cos.cpp $(ls src/*.cpp | grep -v 'main\|sdl') -o test_cos
+//     ./test_cos
+// The exit status is 0 when every case passes.
+
+#include "cos.h"
+#include <iostream>
+#include <string>
+#include <cmath>
+
+using namespace ensiie;
+
+namespace
+{
+    const double tolerance = 1e-10;
+
+    double normal_cdf(double x)
+    {
+        return 0.5 * std::erfc(-x / std::sqrt(2.0));
+    }
+
+    double black_scholes(double S, double K, double T, double r, double sigma, bool call)
+    {
+        if (S <= 0)
+        {
+            return call ? 0 : K * std::exp(-r * T);
+        }
+        double d1 = (std::log(S / K) + (r + 0.5 * sigma * sigma) * T) / (sigma * std::sqrt(T));
+        double d2 = d1 - sigma * std::sqrt(T);
+        if (call)
+        {
+            return S * normal_cdf(d1) - K * std::exp(-r * T) * normal_cdf(d2);
+        }
+        return K * std::exp(-r * T) * normal_cdf(-d2) - S * normal_cdf(-d1);
+    }
+
+    int failures = 0;
+
+    void check(const std::string& name, double error)
+    {
+        std::cout << (error <= tolerance ? "ok   " : "FAIL ") << name << ": maximum error " << error << '\n';
+        failures += !(error <= tolerance);
+    }
+}
+
+int main()
+{
+    const double r = 0.05;
+    const double K = 100;
+    const double L = 300;
+    const int N = 1000;
+
+    for (double T : { 1.0, 0.1, 0.01, 1.0 / 365 })
+    {
+        for (double sigma : { 0.1, 0.4 })
+        {
+            std::string name = "T = " + std::to_string(T) + ", sigma = " + std::to_string(sigma);
+
+            Cos cos(T, r, sigma, K, L, 100, N);
+            cos.pricing();
+            double error = 0;
+            for (int j = 0; j <= N; j++)
+            {
+                double s = j * L / N;
+                error = std::max(error, std::fabs(cos.get_call_price()[j] - black_scholes(s, K, T, r, sigma, true)));
+                error = std::max(error, std::fabs(cos.get_put_price()[j] - black_scholes(s, K, T, r, sigma, false)));
+            }
+            check(name + ", grid", error);
+
+            std::vector<double> strikes;
+            for (int i = 0; i < 200; i++)
+            {
+                strikes.push_back(20 + i);
+            }
+            std::vector<double> call = cos.call_ladder(K, strikes);
+            std::vector<double> put = cos.put_ladder(K, strikes);
+            error = 0;
+            for (int i = 0; i < (int)strikes.size(); i++)
+            {
+                error = std::max(error, std::fabs(call[i] - black_scholes(K, strikes[i], T, r, sigma, true)));
+                error = std::max(error, std::fabs(put[i] - black_scholes(K, strikes[i], T, r, sigma, false)));
+            }
+            check(name + ", ladder", error);
+        }
+    }
+
+    std::cout << (failures == 0 ? "All cases match the Black-Scholes formula\n" : "Some cases do not match the Black-Scholes formula\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
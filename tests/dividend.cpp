@@ -0,0 +1,84 @@
+// Test of a cash dividend whose ex-date is the maturity.
+//
+// The jump condition then applies to the payoff: max(s - D - K, 0) and max(K - (s - D), 0)
+// are the payoffs of the strike K + D, with the same boundary conditions. With an amount that
+// is a whole number of price steps the remap is exact, so the uniform, adaptive and Parareal
+// sweeps must give the prices of the strike K + D without dividend, up to rounding.
+//
+// Build and run from the root of the repository:
+//     g++ -O2 -std=c++17 -pthread -Isrc tests/dividend.cpp $(ls src/*.cpp | grep -v 'main\|sdl') -o test_dividend
+//     ./test_dividend
+// The exit status is 0 when every sweep passes.
+
+#include "completecall.h"
+#include "completeput.h"
+#include <iostream>
+#include <string>
+#include <cmath>
+
+using namespace ensiie;
+
+namespace
+{
+    const double tolerance = 1e-10;
+
+    enum Sweep { uniform, adaptive, parareal };
+
+    void configure(Complete& engine, Sweep sweep)
+    {
+        if (sweep == adaptive)
+        {
+            engine.set_tolerance(1e-4);
+        }
+        else if (sweep == parareal)
+        {
+            engine.set_parareal(4, 0);
+        }
+    }
+
+    // Largest difference on the nodes away from the boundaries
+    template <typename Engine>
+    double difference(Sweep sweep)
+    {
+        const double T = 1, r = 0.05, sigma = 0.2, K = 100, L = 300, M = 200, N = 2000;
+        const double D = 30 * L / N;
+
+        Engine dividend(T, r, sigma, K, L, M, N);
+        configure(dividend, sweep);
+        dividend.add_dividend(T, D);
+        dividend.pricing();
+
+        Engine shifted(T, r, sigma, K + D, L, M, N);
+        configure(shifted, sweep);
+        shifted.pricing();
+
+        double error = 0;
+        for (int j = (int)N / 10; j <= 9 * (int)N / 10; j++)
+        {
+            error = std::max(error, std::fabs(dividend.get_price()[j] - shifted.get_price()[j]));
+        }
+        return error;
+    }
+
+    int failures = 0;
+
+    void check(const std::string& name, double error)
+    {
+        std::cout << (error <= tolerance ? "ok   " : "FAIL ") << name << ": maximum difference " << error << '\n';
+        failures += !(error <= tolerance);
+    }
+}
+
+int main()
+{
+    const std::string names[] = { "uniform", "adaptive", "Parareal" };
+
+    for (Sweep sweep : { uniform, adaptive, parareal })
+    {
+        check("CompleteCall, " + names[sweep] + " sweep", difference<CompleteCall>(sweep));
+        check("CompletePut, " + names[sweep] + " sweep", difference<CompletePut>(sweep));
+    }
+
+    std::cout << (failures == 0 ? "A dividend at maturity shifts the strike in every sweep\n" : "Some sweeps apply a dividend at maturity elsewhere\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file